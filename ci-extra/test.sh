@@ -22,6 +22,9 @@ if [[ $BUILD_TYPE == 'Debug' && -n $(which gdb) && $(uname -s) != MINGW* ]]; the
     -ex 'run' \
     -ex 'thread apply all bt -frame-info source-and-location -full' \
     --args cmake-build-"$BUILD_TYPE"/tests
+elif [[ $BUILD_TYPE == 'ThreadSanitized' ]]; then
+  # TSan cannot map its shadow memory with full address space randomization.
+  setarch "$(uname -m)" -R cmake-build-"$BUILD_TYPE"/tests
 else
   cmake-build-"$BUILD_TYPE"/tests
 fi
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "bitset-common.h"
+#include "bitset-iterator.h"
+#include "bitset-view.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Word-at-a-time counterparts of the standard algorithms for bitset iterators.
+// Each one processes whole words through get_word/set_word, masking only the
+// last partial word, instead of going through bitset_reference bit by bit.
+namespace bitset_algo {
+template <typename T>
+using const_view_of = bitset_view<const std::remove_const_t<T>>;
+
+template <typename T, bitset_common::NonConst U>
+bitset_iterator<U> copy(bitset_iterator<T> first, bitset_iterator<T> last, bitset_iterator<U> result) {
+  bitset_iterator<U> result_last = result + (last - first);
+  bitset_view<U>(result, result_last).assign(const_view_of<T>(first, last));
+  return result_last;
+}
+
+// Copies all bits of `src` to the beginning of `dst` with memmove semantics:
+// the views may overlap in either direction. Returns the written part of `dst`.
+template <bitset_common::NonConst T>
+bitset_view<T> copy_bits(const std::type_identity_t<bitset_view<const T>>& src, const bitset_view<T>& dst) {
+  return dst.subview(0, src.size()).assign(src);
+}
+
+template <bitset_common::NonConst T>
+void fill(bitset_iterator<T> first, bitset_iterator<T> last, bool value) {
+  bitset_view<T> range(first, last);
+  if (value) {
+    range.set();
+  } else {
+    range.reset();
+  }
+}
+
+template <typename T>
+std::ptrdiff_t count(bitset_iterator<T> first, bitset_iterator<T> last, bool value) {
+  auto ones = static_cast<std::ptrdiff_t>(const_view_of<T>(first, last).count());
+  return value ? ones : (last - first) - ones;
+}
+
+template <typename T>
+bitset_iterator<T> find(bitset_iterator<T> first, bitset_iterator<T> last, bool value) {
+  const_view_of<T> range(first, last);
+  std::size_t size = range.size();
+  for (std::size_t n = 0; n < range.words_number(); ++n) {
+    std::size_t bits = std::min(bitset_common::WORD_BITS, size - n * bitset_common::WORD_BITS);
+    bitset_common::word_type word = range.get_word(n, bits);
+    if (!value) {
+      word = ~word & bitset_common::low_bits(bits);
+    }
+    if (word != 0) {
+      return first + (n * bitset_common::WORD_BITS + std::countr_zero(word));
+    }
+  }
+  return last;
+}
+
+template <typename T, typename U>
+std::pair<bitset_iterator<T>, bitset_iterator<U>>
+mismatch(bitset_iterator<T> first1, bitset_iterator<T> last1, bitset_iterator<U> first2) {
+  const_view_of<T> range1(first1, last1);
+  const_view_of<U> range2(first2, first2 + (last1 - first1));
+  std::size_t size = range1.size();
+  for (std::size_t n = 0; n < range1.words_number(); ++n) {
+    std::size_t bits = std::min(bitset_common::WORD_BITS, size - n * bitset_common::WORD_BITS);
+    bitset_common::word_type diff = range1.get_word(n, bits) ^ range2.get_word(n, bits);
+    if (diff != 0) {
+      std::size_t offset = n * bitset_common::WORD_BITS + std::countr_zero(diff);
+      return {first1 + offset, first2 + offset};
+    }
+  }
+  return {last1, first2 + size};
+}
+
+template <typename T, typename U>
+bool equal(bitset_iterator<T> first1, bitset_iterator<T> last1, bitset_iterator<U> first2) {
+  return mismatch(first1, last1, first2).first == last1;
+}
+
+template <typename T, typename U>
+bool equal(bitset_iterator<T> first1, bitset_iterator<T> last1, bitset_iterator<U> first2, bitset_iterator<U> last2) {
+  return (last1 - first1) == (last2 - first2) && equal(first1, last1, first2);
+}
+} // namespace bitset_algo
@@ -0,0 +1,157 @@
+#include "bitset-arith.h"
+
+#include <algorithm>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace bitset_arith {
+namespace {
+using word_type = bitset::word_type;
+
+#if defined(__SIZEOF_INT128__)
+// __extension__ keeps -pedantic quiet about the non-standard type.
+__extension__ typedef unsigned __int128 double_word;
+#endif
+
+std::size_t word_bits(std::size_t size, std::size_t n) {
+  return std::min(bitset_common::WORD_BITS, size - n * bitset_common::WORD_BITS);
+}
+
+// Word `n` of an operand, zero past its end.
+word_type operand_word(const bitset::const_view& operand, std::size_t n, std::size_t bits) {
+  std::size_t first = n * bitset_common::WORD_BITS;
+  if (first >= operand.size()) {
+    return 0;
+  }
+  return operand.get_word(n, std::min(bits, operand.size() - first));
+}
+
+word_type add_carry(word_type lhs, word_type rhs, bool& carry) {
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long long result;
+  carry = _addcarry_u64(carry, lhs, rhs, &result);
+  return result;
+#else
+  word_type result;
+  bool first = __builtin_add_overflow(lhs, rhs, &result);
+  bool second = __builtin_add_overflow(result, word_type(carry), &result);
+  carry = first || second;
+  return result;
+#endif
+}
+
+word_type sub_borrow(word_type lhs, word_type rhs, bool& borrow) {
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long long result;
+  borrow = _subborrow_u64(borrow, lhs, rhs, &result);
+  return result;
+#else
+  word_type result;
+  bool first = __builtin_sub_overflow(lhs, rhs, &result);
+  bool second = __builtin_sub_overflow(result, word_type(borrow), &result);
+  borrow = first || second;
+  return result;
+#endif
+}
+
+// lhs * rhs + addend as a low and a high word.
+word_type mul_add(word_type lhs, word_type rhs, word_type addend, word_type& high) {
+#if defined(__SIZEOF_INT128__)
+  double_word product = static_cast<double_word>(lhs) * rhs + addend;
+  high = static_cast<word_type>(product >> bitset_common::WORD_BITS);
+  return static_cast<word_type>(product);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long long result;
+  unsigned char carry = _addcarry_u64(0, _umul128(lhs, rhs, &high), addend, &result);
+  high += carry;
+  return result;
+#else
+  constexpr std::size_t HALF = bitset_common::WORD_BITS / 2;
+  constexpr word_type LOW = bitset_common::low_bits(HALF);
+  word_type ll = (lhs & LOW) * (rhs & LOW);
+  word_type lh = (lhs & LOW) * (rhs >> HALF);
+  word_type hl = (lhs >> HALF) * (rhs & LOW);
+  word_type hh = (lhs >> HALF) * (rhs >> HALF);
+  word_type middle = (ll >> HALF) + (lh & LOW) + (hl & LOW);
+  word_type low = (middle << HALF) | (ll & LOW);
+  high = hh + (lh >> HALF) + (hl >> HALF) + (middle >> HALF);
+  bool carry = false;
+  low = add_carry(low, addend, carry);
+  high += carry;
+  return low;
+#endif
+}
+} // namespace
+
+bool add_assign(const bitset::view& target, const bitset::const_view& addend, bool carry) {
+  std::size_t words = target.words_number();
+  std::size_t addend_words = std::min(words, addend.words_number());
+  for (std::size_t n = 0; n < words; ++n) {
+    if (n >= addend_words && !carry) {
+      return false;
+    }
+    std::size_t bits = word_bits(target.size(), n);
+    word_type lhs = target.get_word(n, bits);
+    word_type rhs = operand_word(addend, n, bits);
+    if (bits < bitset_common::WORD_BITS) {
+      // Both operands fit in `bits` bits, so the carry lands on bit `bits`.
+      word_type sum = lhs + rhs + carry;
+      target.set_word(sum, n, bits);
+      return (sum >> bits) != 0;
+    }
+    target.set_word(add_carry(lhs, rhs, carry), n);
+  }
+  return carry;
+}
+
+bool sub_assign(const bitset::view& target, const bitset::const_view& subtrahend, bool borrow) {
+  std::size_t words = target.words_number();
+  std::size_t subtrahend_words = std::min(words, subtrahend.words_number());
+  for (std::size_t n = 0; n < words; ++n) {
+    if (n >= subtrahend_words && !borrow) {
+      return false;
+    }
+    std::size_t bits = word_bits(target.size(), n);
+    word_type lhs = target.get_word(n, bits);
+    word_type rhs = operand_word(subtrahend, n, bits);
+    if (bits < bitset_common::WORD_BITS) {
+      // A borrow wraps the difference around, setting every bit from `bits` up.
+      word_type difference = lhs - rhs - borrow;
+      target.set_word(difference, n, bits);
+      return (difference >> bits) != 0;
+    }
+    target.set_word(sub_borrow(lhs, rhs, borrow), n);
+  }
+  return borrow;
+}
+
+bool increment(const bitset::view& target) {
+  return add_assign(target, bitset::const_view(), true);
+}
+
+std::strong_ordering compare(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  for (std::size_t n = std::max(lhs.words_number(), rhs.words_number()); n-- > 0;) {
+    word_type lhs_word = operand_word(lhs, n, bitset_common::WORD_BITS);
+    word_type rhs_word = operand_word(rhs, n, bitset_common::WORD_BITS);
+    if (lhs_word != rhs_word) {
+      return lhs_word <=> rhs_word;
+    }
+  }
+  return std::strong_ordering::equal;
+}
+
+word_type mul_small(const bitset::view& target, word_type factor) {
+  word_type carry = 0;
+  for (std::size_t n = 0; n < target.words_number(); ++n) {
+    std::size_t bits = word_bits(target.size(), n);
+    word_type high;
+    word_type low = mul_add(target.get_word(n, bits), factor, carry, high);
+    target.set_word(low, n, bits);
+    // For a partial last word the overflow starts at bit `bits` of the product.
+    carry = bits < bitset_common::WORD_BITS ? (low >> bits) | (high << (bitset_common::WORD_BITS - bits)) : high;
+  }
+  return carry;
+}
+} // namespace bitset_arith
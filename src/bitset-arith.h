@@ -0,0 +1,31 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <compare>
+
+// Views as unsigned little-endian integers: bit 0 is the least significant
+// bit. Each operation runs one carry chain over whole words; unaligned views
+// are realigned word by word through get_word and set_word. An operand may be
+// shorter than the target and is then zero-extended; it may be the target
+// itself, but must not otherwise overlap it.
+namespace bitset_arith {
+// target += addend (+ 1 with `carry`). Returns the carry out of the top bit.
+bool add_assign(const bitset::view& target, const bitset::const_view& addend, bool carry = false);
+
+// target -= subtrahend (- 1 with `borrow`). Returns the borrow out of the top
+// bit, that is whether the exact result was negative.
+bool sub_assign(const bitset::view& target, const bitset::const_view& subtrahend, bool borrow = false);
+
+// Adds one, stopping at the first word that does not overflow. Returns true
+// when the view wrapped around to zero.
+bool increment(const bitset::view& target);
+
+// Unsigned magnitude comparison; views of different sizes are compared as if
+// the shorter one was zero-extended.
+std::strong_ordering compare(const bitset::const_view& lhs, const bitset::const_view& rhs);
+
+// target *= factor. Returns the part of the product that does not fit in the
+// view, that is the exact product shifted right by target.size() bits.
+bitset::word_type mul_small(const bitset::view& target, bitset::word_type factor);
+} // namespace bitset_arith
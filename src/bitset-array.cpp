@@ -0,0 +1,245 @@
+#include "bitset-array.h"
+
+#include "bitset-streaming.h"
+
+#include <algorithm>
+#include <bit>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+// Rows prefetched ahead of the one being copied by gather.
+constexpr std::size_t GATHER_PREFETCH_ROWS = 8;
+// Words allocated by deserialize before the first read: 1 MiB.
+constexpr std::size_t DESERIALIZE_CHUNK_WORDS = std::size_t(1) << 17;
+
+std::size_t words_for(std::size_t bits) {
+  return (bits + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS;
+}
+
+// Common size of `rows`, checked before anything is allocated.
+std::size_t common_size(std::span<const bitset> rows) {
+  if (rows.empty()) {
+    return 0;
+  }
+  for (const bitset& row : rows) {
+    if (row.size() != rows.front().size()) {
+      throw std::invalid_argument("bitset array rows differ in size");
+    }
+  }
+  return rows.front().size();
+}
+} // namespace
+
+bitset_array::bitset_array()
+    : size_(0)
+    , bits_(0)
+    , stride_(0) {}
+
+bitset_array::bitset_array(std::size_t size, std::size_t bits)
+    : size_(size)
+    , bits_(bits)
+    , stride_(words_for(bits))
+    , rows_(size * stride_ * bitset_common::WORD_BITS, false) {}
+
+bitset_array::bitset_array(std::size_t size, std::size_t bits, bool value)
+    : bitset_array(size, bits) {
+  if (value) {
+    rows_.set();
+    clear_padding();
+  }
+}
+
+bitset_array::bitset_array(std::span<const bitset> rows)
+    : bitset_array(rows.size(), common_size(rows)) {
+  for (std::size_t i = 0; i < size_; ++i) {
+    (*this)[i].assign(rows[i]);
+  }
+}
+
+void bitset_array::swap(bitset_array& other) noexcept {
+  std::swap(size_, other.size_);
+  std::swap(bits_, other.bits_);
+  std::swap(stride_, other.stride_);
+  rows_.swap(other.rows_);
+}
+
+std::size_t bitset_array::size() const {
+  return size_;
+}
+
+std::size_t bitset_array::bits() const {
+  return bits_;
+}
+
+std::size_t bitset_array::stride() const {
+  return stride_;
+}
+
+bool bitset_array::empty() const {
+  return size() == 0;
+}
+
+bitset_array::view bitset_array::operator[](std::size_t index) {
+  return rows_.subview(index * stride_ * bitset_common::WORD_BITS, bits_);
+}
+
+bitset_array::const_view bitset_array::operator[](std::size_t index) const {
+  return rows_.subview(index * stride_ * bitset_common::WORD_BITS, bits_);
+}
+
+void bitset_array::push_back(const const_view& row) {
+  std::size_t offset = size_ * stride_ * bitset_common::WORD_BITS;
+  if ((size_ + 1) * stride_ > rows_.capacity()) {
+    // `row` may be a row of this array: it is copied before the old slab goes away.
+    bitset grown = reallocated(std::max<std::size_t>(2 * size_, 16));
+    grown.subview(offset, bits_).assign(row);
+    rows_.swap(grown);
+  } else {
+    rows_.subview(offset, bits_).assign(row);
+  }
+  ++size_;
+}
+
+void bitset_array::reserve(std::size_t rows) {
+  if (rows * stride_ > rows_.capacity()) {
+    bitset grown = reallocated(rows);
+    rows_.swap(grown);
+  }
+}
+
+void bitset_array::clear() {
+  size_ = 0;
+}
+
+bitset bitset_array::or_rows() const {
+  bitset result(bits_, false);
+  word_type* acc = result.data();
+  for (std::size_t i = 0; i < size_; ++i) {
+    const word_type* row = row_data(i);
+    for (std::size_t n = 0; n < stride_; ++n) {
+      acc[n] |= row[n];
+    }
+  }
+  return result;
+}
+
+void bitset_array::counts(std::span<std::size_t> out) const {
+  for (std::size_t i = 0; i < size_; ++i) {
+    const word_type* row = row_data(i);
+    std::size_t count = 0;
+    for (std::size_t n = 0; n < stride_; ++n) {
+      count += std::popcount(row[n]);
+    }
+    out[i] = count;
+  }
+}
+
+bitset_array bitset_array::gather(std::span<const uint32_t> indices) const {
+  return gatherRows(indices);
+}
+
+bitset_array bitset_array::gather(std::span<const uint64_t> indices) const {
+  return gatherRows(indices);
+}
+
+// Gathered rows are scattered over the slab, so the hardware prefetcher cannot
+// follow them; each row is requested explicitly a few rows ahead of its copy.
+template <typename Index>
+bitset_array bitset_array::gatherRows(std::span<const Index> indices) const {
+  bitset_array result(indices.size(), bits_);
+  for (std::size_t i = 0; i < indices.size(); ++i) {
+    if (i + GATHER_PREFETCH_ROWS < indices.size()) {
+      const word_type* ahead = row_data(indices[i + GATHER_PREFETCH_ROWS]);
+      for (std::size_t n = 0; n < stride_; n += bitset_streaming::CACHE_LINE_WORDS) {
+        bitset_streaming::prefetch(ahead + n);
+      }
+    }
+    std::copy_n(row_data(indices[i]), stride_, result.row_data(i));
+  }
+  return result;
+}
+
+void bitset_array::serialize(std::ostream& out) const {
+  uint64_t header[] = {size_, bits_};
+  out.write(reinterpret_cast<const char*>(header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(rows_.data()), size_ * stride_ * sizeof(word_type));
+}
+
+bitset_array bitset_array::deserialize(std::istream& in) {
+  uint64_t header[2] = {};
+  in.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!in) {
+    throw std::invalid_argument("bitset array stream is truncated");
+  }
+  constexpr std::size_t MAX_BITS = std::numeric_limits<std::size_t>::max();
+  std::size_t stride = header[1] / bitset_common::WORD_BITS + (header[1] % bitset_common::WORD_BITS != 0);
+  if (stride != 0 && header[0] > MAX_BITS / bitset_common::WORD_BITS / stride) {
+    throw std::invalid_argument("bitset array header is too large");
+  }
+  bitset_array result;
+  result.size_ = header[0];
+  result.bits_ = header[1];
+  result.stride_ = stride;
+  // The slab grows geometrically as it is read, so a header claiming more rows
+  // than the stream holds fails before allocating more than twice what was read.
+  std::size_t words = result.size_ * result.stride_;
+  for (std::size_t read = 0; read < words;) {
+    std::size_t chunk = std::min(words - read, std::max(read, DESERIALIZE_CHUNK_WORDS));
+    bitset grown((read + chunk) * bitset_common::WORD_BITS);
+    std::copy_n(result.rows_.data(), read, grown.data());
+    result.rows_.swap(grown);
+    in.read(reinterpret_cast<char*>(result.rows_.data() + read), chunk * sizeof(word_type));
+    if (!in) {
+      throw std::invalid_argument("bitset array stream is truncated");
+    }
+    read += chunk;
+  }
+  result.clear_padding();
+  return result;
+}
+
+bitset_array::word_type* bitset_array::row_data(std::size_t index) {
+  return rows_.data() + index * stride_;
+}
+
+const bitset_array::word_type* bitset_array::row_data(std::size_t index) const {
+  return rows_.data() + index * stride_;
+}
+
+bitset bitset_array::reallocated(std::size_t rows) const {
+  bitset result(rows * stride_ * bitset_common::WORD_BITS, false);
+  std::copy_n(rows_.data(), size_ * stride_, result.data());
+  return result;
+}
+
+void bitset_array::clear_padding() {
+  std::size_t tail = bits_ % bitset_common::WORD_BITS;
+  if (tail != 0) {
+    for (std::size_t i = 0; i < size_; ++i) {
+      row_data(i)[stride_ - 1] &= bitset_common::low_bits(tail);
+    }
+  }
+}
+
+void swap(bitset_array& lhs, bitset_array& rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+bool operator==(const bitset_array& lhs, const bitset_array& rhs) {
+  if (lhs.size() != rhs.size() || lhs.bits() != rhs.bits()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    if (lhs[i] != rhs[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool operator!=(const bitset_array& lhs, const bitset_array& rhs) {
+  return !(lhs == rhs);
+}
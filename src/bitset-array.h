@@ -0,0 +1,82 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+
+// Sequence of equally sized bitsets sharing one aligned allocation. Row `i`
+// occupies words [i * stride(), (i + 1) * stride()) of the slab, so a pass over
+// consecutive rows is a single linear sweep. Padding bits past bits() in the
+// last word of every row are kept zero.
+class bitset_array {
+public:
+  using word_type = bitset::word_type;
+  using reference = bitset::reference;
+  using const_reference = bitset::const_reference;
+  using view = bitset::view;
+  using const_view = bitset::const_view;
+
+  bitset_array();
+  bitset_array(std::size_t size, std::size_t bits, bool value);
+  // Throws std::invalid_argument if the rows differ in size.
+  explicit bitset_array(std::span<const bitset> rows);
+
+  void swap(bitset_array& other) noexcept;
+
+  // Number of rows.
+  std::size_t size() const;
+  // Length of every row.
+  std::size_t bits() const;
+  // Distance between the starts of consecutive rows, in words.
+  std::size_t stride() const;
+  bool empty() const;
+
+  view operator[](std::size_t index);
+  const_view operator[](std::size_t index) const;
+
+  // Appends a row of bits() bits, growing the slab geometrically. Growing
+  // invalidates views of existing rows.
+  void push_back(const const_view& row);
+  void reserve(std::size_t rows);
+  void clear();
+
+  // OR of all rows, of bits() bits.
+  bitset or_rows() const;
+  // out[i] is the number of set bits of row i.
+  void counts(std::span<std::size_t> out) const;
+  // Array of rows indices[0], indices[1], ..., in that order.
+  bitset_array gather(std::span<const uint32_t> indices) const;
+  bitset_array gather(std::span<const uint64_t> indices) const;
+
+  // Writes size() and bits() followed by the slab as is: size() * stride() words.
+  void serialize(std::ostream& out) const;
+  // Throws std::invalid_argument if the stream ends early or the header
+  // describes a slab too large to address.
+  static bitset_array deserialize(std::istream& in);
+
+private:
+  bitset_array(std::size_t size, std::size_t bits);
+
+  word_type* row_data(std::size_t index);
+  const word_type* row_data(std::size_t index) const;
+  // Copy of the used rows in a slab with room for `rows` rows.
+  bitset reallocated(std::size_t rows) const;
+  void clear_padding();
+
+  template <typename Index>
+  bitset_array gatherRows(std::span<const Index> indices) const;
+
+private:
+  std::size_t size_;
+  std::size_t bits_;
+  std::size_t stride_;
+  bitset rows_;
+};
+
+void swap(bitset_array& lhs, bitset_array& rhs) noexcept;
+
+bool operator==(const bitset_array& lhs, const bitset_array& rhs);
+bool operator!=(const bitset_array& lhs, const bitset_array& rhs);
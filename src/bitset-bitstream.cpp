@@ -0,0 +1,161 @@
+#include "bitset-bitstream.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+// Words the writer's storage starts with once something is written.
+constexpr std::size_t INITIAL_WORDS = 16;
+} // namespace
+
+bit_writer::bit_writer()
+    : words_(0)
+    , pending_(0)
+    , pending_bits_(0) {}
+
+std::size_t bit_writer::size() const {
+  return words_ * bitset_common::WORD_BITS + pending_bits_;
+}
+
+void bit_writer::write(word_type value, std::size_t bits) {
+  if (bits == 0) {
+    return;
+  }
+  value &= bitset_common::low_bits(bits);
+  pending_ |= value << pending_bits_;
+  pending_bits_ += bits;
+  if (pending_bits_ >= bitset_common::WORD_BITS) {
+    store(pending_);
+    pending_bits_ -= bitset_common::WORD_BITS;
+    // The top pending_bits_ bits of `value` did not fit in the stored word.
+    pending_ = pending_bits_ == 0 ? 0 : value >> (bits - pending_bits_);
+  }
+}
+
+void bit_writer::write_bit(bool value) {
+  write(value ? bitset_common::ONE : bitset_common::ZERO, 1);
+}
+
+void bit_writer::write_bits(const bitset::const_view& bits) {
+  for (std::size_t n = 0; n < bits.words_number(); ++n) {
+    std::size_t word_bits = std::min(bitset_common::WORD_BITS, bits.size() - n * bitset_common::WORD_BITS);
+    write(bits.get_word(n, word_bits), word_bits);
+  }
+}
+
+void bit_writer::write_unary(std::size_t count) {
+  for (; count >= bitset_common::WORD_BITS; count -= bitset_common::WORD_BITS) {
+    write(0, bitset_common::WORD_BITS);
+  }
+  write(bitset_common::ONE << count, count + 1);
+}
+
+void bit_writer::write_gamma(word_type value) {
+  if (value == 0) {
+    throw std::invalid_argument("bit_writer cannot gamma-code zero");
+  }
+  std::size_t width = std::bit_width(value) - 1;
+  write_unary(width);
+  write(value, width);
+}
+
+bitset bit_writer::release() {
+  std::size_t bits = size();
+  if (pending_bits_ != 0) {
+    store(pending_);
+  }
+  bitset result;
+  if (words_ == bits_.capacity()) {
+    result.swap(bits_);
+    result.size_ = bits;
+  } else {
+    bitset exact(bits);
+    std::copy_n(bits_.data(), words_, exact.data());
+    result.swap(exact);
+  }
+  bitset().swap(bits_);
+  words_ = 0;
+  pending_ = 0;
+  pending_bits_ = 0;
+  return result;
+}
+
+void bit_writer::store(word_type word) {
+  if (words_ == bits_.capacity()) {
+    bitset grown(std::max(2 * words_, INITIAL_WORDS) * bitset_common::WORD_BITS);
+    std::copy_n(bits_.data(), words_, grown.data());
+    bits_.swap(grown);
+  }
+  bits_.data()[words_] = word;
+  bits_.mark_dirty(bits_.data() + words_, 1);
+  ++words_;
+}
+
+bit_reader::bit_reader(const bitset::const_view& bits)
+    : bits_(bits)
+    , current_(bits.begin())
+    , position_(0) {}
+
+std::size_t bit_reader::position() const {
+  return position_;
+}
+
+std::size_t bit_reader::remaining() const {
+  return bits_.size() - position_;
+}
+
+bit_reader::word_type bit_reader::read(std::size_t bits) {
+  word_type result = peek(bits);
+  skip(bits);
+  return result;
+}
+
+bool bit_reader::read_bit() {
+  return read(1) != 0;
+}
+
+std::size_t bit_reader::read_unary() {
+  std::size_t count = 0;
+  while (true) {
+    std::size_t bits = std::min(bitset_common::WORD_BITS, remaining());
+    word_type word = peek(bits);
+    if (word != 0) {
+      std::size_t zeros = std::countr_zero(word);
+      skip(zeros + 1);
+      return count + zeros;
+    }
+    if (bits == 0) {
+      throw std::out_of_range("bit_reader reads past the end");
+    }
+    count += bits;
+    skip(bits);
+  }
+}
+
+bit_reader::word_type bit_reader::read_gamma() {
+  std::size_t width = read_unary();
+  if (width >= bitset_common::WORD_BITS) {
+    throw std::invalid_argument("bit_reader gamma code does not fit in a word");
+  }
+  return (bitset_common::ONE << width) | read(width);
+}
+
+void bit_reader::skip(std::size_t bits) {
+  if (bits > remaining()) {
+    throw std::out_of_range("bit_reader reads past the end");
+  }
+  current_ += bits;
+  position_ += bits;
+}
+
+bit_reader::word_type bit_reader::peek(std::size_t bits) const {
+  if (bits > remaining()) {
+    throw std::out_of_range("bit_reader reads past the end");
+  }
+  if (bits == 0) {
+    return 0;
+  }
+  bitset::const_iterator it = current_;
+  return it.get_word(0, bits);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+
+// Sequential bit-level encoding into and decoding from bitsets. Fields are laid
+// out least significant bit first: a field written at bit `i` of the stream
+// occupies bits i, i + 1, ... with its lowest bit first, which is exactly how
+// get_word reads it back.
+//
+// unary(n) is n zeros followed by a one. gamma(v), for v >= 1 of bit width
+// w + 1, is unary(w) followed by the low w bits of v: the one ending the unary
+// part doubles as the leading one of v, as in Elias gamma.
+
+// Appends fields to a growable bitset. Bits are collected in a 64-bit
+// accumulator and stored a whole word at a time.
+class bit_writer {
+public:
+  using word_type = bitset::word_type;
+
+  bit_writer();
+
+  // Number of bits written so far.
+  std::size_t size() const;
+
+  // Writes the low `bits` bits of `value`, `bits` <= WORD_BITS.
+  void write(word_type value, std::size_t bits);
+  void write_bit(bool value);
+  void write_bits(const bitset::const_view& bits);
+  void write_unary(std::size_t count);
+  // Throws std::invalid_argument for zero, which has no gamma code.
+  void write_gamma(word_type value);
+
+  // Everything written so far as a bitset of size() bits; the writer is left
+  // empty. No copy is made when the storage happens to have the exact size.
+  bitset release();
+
+private:
+  void store(word_type word);
+
+private:
+  bitset bits_;
+  std::size_t words_;
+  word_type pending_;
+  std::size_t pending_bits_;
+};
+
+// Reads fields back from a view, up to a word at a time. Reading past the end
+// of the view throws std::out_of_range.
+class bit_reader {
+public:
+  using word_type = bitset::word_type;
+
+  explicit bit_reader(const bitset::const_view& bits);
+
+  std::size_t position() const;
+  std::size_t remaining() const;
+
+  // Reads `bits` bits, `bits` <= WORD_BITS, into the low bits of the result.
+  word_type read(std::size_t bits);
+  bool read_bit();
+  // Counts zeros a word at a time with countr_zero, then consumes the one.
+  std::size_t read_unary();
+  // Throws std::invalid_argument if the code does not fit in a word.
+  word_type read_gamma();
+  void skip(std::size_t bits);
+
+private:
+  word_type peek(std::size_t bits) const;
+
+private:
+  bitset::const_view bits_;
+  bitset::const_iterator current_;
+  std::size_t position_;
+};
@@ -0,0 +1,187 @@
+#include "bitset-bloom.h"
+
+#include "bitset-simd.h"
+#include "bitset-streaming.h"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+// Words allocated by deserialize before the first read: 1 MiB.
+constexpr std::size_t DESERIALIZE_CHUNK_WORDS = std::size_t(1) << 17;
+
+void check_hashes(std::size_t hashes) {
+  if (hashes == 0 || hashes > blocked_bloom_filter::BLOCK_BITS) {
+    throw std::invalid_argument("blocked bloom filter has an invalid number of hashes");
+  }
+}
+
+void check_blocks(std::size_t blocks) {
+  if (blocks == 0 || blocks > blocked_bloom_filter::MAX_BLOCKS) {
+    throw std::invalid_argument("blocked bloom filter has an invalid number of blocks");
+  }
+}
+
+// Blocks needed for `bits` bits, at least one; checked before anything is allocated.
+std::size_t checked_blocks(std::size_t bits, std::size_t hashes) {
+  check_hashes(hashes);
+  std::size_t blocks = std::max<std::size_t>(
+      bits / blocked_bloom_filter::BLOCK_BITS + (bits % blocked_bloom_filter::BLOCK_BITS != 0), 1
+  );
+  check_blocks(blocks);
+  return blocks;
+}
+} // namespace
+
+blocked_bloom_filter::blocked_bloom_filter(std::size_t bits, std::size_t hashes)
+    : hashes_(hashes)
+    , bits_(checked_blocks(bits, hashes) * BLOCK_BITS, false) {}
+
+void blocked_bloom_filter::swap(blocked_bloom_filter& other) noexcept {
+  std::swap(hashes_, other.hashes_);
+  bits_.swap(other.bits_);
+}
+
+std::size_t blocked_bloom_filter::size() const {
+  return bits_.size();
+}
+
+std::size_t blocked_bloom_filter::blocks() const {
+  return size() / BLOCK_BITS;
+}
+
+std::size_t blocked_bloom_filter::hashes() const {
+  return hashes_;
+}
+
+std::size_t blocked_bloom_filter::block_index(uint64_t hash) const {
+  // Maps the upper half of the hash onto [0, blocks()) without a division.
+  return ((hash >> 32) * blocks()) >> 32;
+}
+
+blocked_bloom_filter::block_mask blocked_bloom_filter::mask(uint64_t hash) const {
+  block_mask result{};
+  auto h = static_cast<uint32_t>(hash);
+  uint32_t step = (h >> 9) | 1;
+  for (std::size_t i = 0; i < hashes_; ++i) {
+    uint32_t bit = h % BLOCK_BITS;
+    result[bit / bitset_common::WORD_BITS] |= bitset_common::ONE << (bit % bitset_common::WORD_BITS);
+    h += step;
+  }
+  return result;
+}
+
+bitset::word_type* blocked_bloom_filter::block(uint64_t hash) {
+  return bits_.data() + block_index(hash) * BLOCK_WORDS;
+}
+
+const bitset::word_type* blocked_bloom_filter::block(uint64_t hash) const {
+  return bits_.data() + block_index(hash) * BLOCK_WORDS;
+}
+
+void blocked_bloom_filter::insert(uint64_t hash) {
+  bitset::word_type* words = block(hash);
+  block_mask m = mask(hash);
+  for (std::size_t w = 0; w < BLOCK_WORDS; ++w) {
+    words[w] |= m[w];
+  }
+  bits_.mark_dirty(words, BLOCK_WORDS);
+}
+
+void blocked_bloom_filter::insert(std::span<const uint64_t> hashes) {
+  for (std::size_t i = 0; i < hashes.size(); ++i) {
+    if (i + PREFETCH_DISTANCE < hashes.size()) {
+      bitset_streaming::prefetch(block(hashes[i + PREFETCH_DISTANCE]));
+    }
+    insert(hashes[i]);
+  }
+}
+
+bool blocked_bloom_filter::contains(uint64_t hash) const {
+  block_mask m = mask(hash);
+  return bitset_simd::covers(block(hash), m.data(), BLOCK_WORDS);
+}
+
+void blocked_bloom_filter::contains(std::span<const uint64_t> hashes, std::span<bool> out) const {
+  for (std::size_t i = 0; i < hashes.size(); ++i) {
+    if (i + PREFETCH_DISTANCE < hashes.size()) {
+      bitset_streaming::prefetch(block(hashes[i + PREFETCH_DISTANCE]));
+    }
+    out[i] = contains(hashes[i]);
+  }
+}
+
+void blocked_bloom_filter::contains(std::span<const uint64_t> hashes, const bitset::view& out) const {
+  bitset::word_type result = 0;
+  for (std::size_t i = 0; i < hashes.size(); ++i) {
+    if (i + PREFETCH_DISTANCE < hashes.size()) {
+      bitset_streaming::prefetch(block(hashes[i + PREFETCH_DISTANCE]));
+    }
+    std::size_t bit = i % bitset_common::WORD_BITS;
+    result |= bitset::word_type(contains(hashes[i])) << bit;
+    if (bit + 1 == bitset_common::WORD_BITS) {
+      out.set_word(result, i / bitset_common::WORD_BITS);
+      result = 0;
+    }
+  }
+  out.set_word(result, hashes.size() / bitset_common::WORD_BITS, hashes.size() % bitset_common::WORD_BITS);
+}
+
+void blocked_bloom_filter::clear() {
+  bits_.reset();
+}
+
+blocked_bloom_filter& blocked_bloom_filter::operator|=(const blocked_bloom_filter& other) & {
+  bits_ |= other.bits_;
+  return *this;
+}
+
+blocked_bloom_filter& blocked_bloom_filter::operator&=(const blocked_bloom_filter& other) & {
+  bits_ &= other.bits_;
+  return *this;
+}
+
+const bitset& blocked_bloom_filter::bits() const {
+  return bits_;
+}
+
+void blocked_bloom_filter::serialize(std::ostream& out) const {
+  uint64_t header[] = {hashes_, blocks()};
+  out.write(reinterpret_cast<const char*>(header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(bits_.data()), blocks() * BLOCK_WORDS * sizeof(bitset::word_type));
+}
+
+blocked_bloom_filter blocked_bloom_filter::deserialize(std::istream& in) {
+  uint64_t header[2] = {};
+  in.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!in) {
+    throw std::invalid_argument("blocked bloom filter stream is truncated");
+  }
+  check_hashes(header[0]);
+  check_blocks(header[1]);
+  blocked_bloom_filter result(BLOCK_BITS, header[0]);
+  // The words grow geometrically as they are read, so a header claiming more
+  // blocks than the stream holds fails before allocating more than twice what
+  // was read.
+  std::size_t words = header[1] * BLOCK_WORDS;
+  bitset read_words;
+  for (std::size_t read = 0; read < words;) {
+    std::size_t chunk = std::min(words - read, std::max(read, DESERIALIZE_CHUNK_WORDS));
+    bitset grown((read + chunk) * bitset_common::WORD_BITS);
+    std::copy_n(read_words.data(), read, grown.data());
+    read_words.swap(grown);
+    in.read(reinterpret_cast<char*>(read_words.data() + read), chunk * sizeof(bitset::word_type));
+    if (!in) {
+      throw std::invalid_argument("blocked bloom filter stream is truncated");
+    }
+    read += chunk;
+  }
+  result.bits_.swap(read_words);
+  return result;
+}
+
+void swap(blocked_bloom_filter& lhs, blocked_bloom_filter& rhs) noexcept {
+  lhs.swap(rhs);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+
+// Bloom filter whose bits are split into 512-bit blocks (one cache line each):
+// all `hashes` probe bits of a key live in the same block, so a lookup costs
+// a single cache miss. Keys are given as 64-bit hashes; the upper 32 bits pick
+// the block and the lower 32 bits pick the bits inside it.
+class blocked_bloom_filter {
+public:
+  static constexpr std::size_t BLOCK_BITS = 512;
+  static constexpr std::size_t BLOCK_WORDS = BLOCK_BITS / bitset_common::WORD_BITS;
+
+  // Number of keys looked ahead by the batch operations when prefetching.
+  static constexpr std::size_t PREFETCH_DISTANCE = 8;
+
+  // At most this many blocks are addressable by the upper half of a hash.
+  static constexpr std::size_t MAX_BLOCKS = std::size_t(1) << 32;
+
+  // Rounds `bits` up to whole blocks (at least one). Throws
+  // std::invalid_argument on zero or more than BLOCK_BITS hashes and on more
+  // than MAX_BLOCKS blocks.
+  blocked_bloom_filter(std::size_t bits, std::size_t hashes);
+
+  void swap(blocked_bloom_filter& other) noexcept;
+
+  std::size_t size() const;
+  std::size_t blocks() const;
+  std::size_t hashes() const;
+
+  void insert(uint64_t hash);
+  void insert(std::span<const uint64_t> hashes);
+
+  bool contains(uint64_t hash) const;
+  void contains(std::span<const uint64_t> hashes, std::span<bool> out) const;
+  void contains(std::span<const uint64_t> hashes, const bitset::view& out) const;
+
+  void clear();
+
+  // Both filters must have the same size and number of hashes.
+  blocked_bloom_filter& operator|=(const blocked_bloom_filter& other) &;
+  blocked_bloom_filter& operator&=(const blocked_bloom_filter& other) &;
+
+  const bitset& bits() const;
+
+  // Binary format: hashes, blocks, then the filter words, all as 64-bit
+  // integers in host byte order. deserialize throws std::invalid_argument on a
+  // short read, on zero or more than BLOCK_BITS hashes, and on zero or more
+  // than MAX_BLOCKS blocks.
+  void serialize(std::ostream& out) const;
+  static blocked_bloom_filter deserialize(std::istream& in);
+
+private:
+  using block_mask = std::array<bitset::word_type, BLOCK_WORDS>;
+
+  std::size_t block_index(uint64_t hash) const;
+  block_mask mask(uint64_t hash) const;
+  bitset::word_type* block(uint64_t hash);
+  const bitset::word_type* block(uint64_t hash) const;
+
+private:
+  std::size_t hashes_;
+  bitset bits_;
+};
+
+void swap(blocked_bloom_filter& lhs, blocked_bloom_filter& rhs) noexcept;
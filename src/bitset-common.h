@@ -15,4 +15,23 @@ static constexpr word_type ALL_BITS = -1;
 static constexpr word_type ZERO = 0;
 static constexpr word_type ONE = 1;
 static constexpr std::size_t WORD_BITS = std::numeric_limits<word_type>::digits;
+
+// Word with the lowest `count` bits set, `count` <= WORD_BITS.
+constexpr word_type low_bits(std::size_t count) {
+  return count == 0 ? ZERO : ALL_BITS >> (WORD_BITS - count);
+}
+
+// The lowest set bit of `x` and every bit above it; zero for zero.
+constexpr word_type lowest_and_above(word_type x) {
+  return ZERO - (x & (ZERO - x));
+}
+
+// Bit `i` of the result is the parity of bits 0..i of `x`: a prefix XOR within
+// the word by shift-doubling.
+constexpr word_type parity_scan(word_type x) {
+  for (std::size_t shift = 1; shift < WORD_BITS; shift *= 2) {
+    x ^= x << shift;
+  }
+  return x;
+}
 } // namespace bitset_common
@@ -0,0 +1,128 @@
+#include "bitset-compress.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+namespace bitset_compress {
+namespace {
+using word_type = bitset::word_type;
+
+std::size_t word_bits(std::size_t size, std::size_t n) {
+  return std::min(bitset_common::WORD_BITS, size - n * bitset_common::WORD_BITS);
+}
+
+constexpr std::size_t ROUNDS = 6;
+
+// Bit i of the result is the XOR of bits 0 ... i of `x`.
+word_type prefix_xor(word_type x) {
+  for (std::size_t shift = 1; shift < bitset_common::WORD_BITS; shift <<= 1) {
+    x ^= x << shift;
+  }
+  return x;
+}
+
+// Bits moved in each round of compress_word_portable for `mask`: round i moves
+// the bits in moves[i] right by 2^i, which expand replays in reverse to the left.
+std::array<word_type, ROUNDS> compress_moves(word_type mask) {
+  std::array<word_type, ROUNDS> moves{};
+  // Bit j of `zeros` is set if bit j - 1 of the mask is clear and still counts
+  // towards the distance the bits above it have to move.
+  word_type zeros = ~mask << 1;
+  for (std::size_t i = 0; i < ROUNDS; ++i) {
+    // Odd number of such zeros below: the bit moves by 2^i in this round.
+    word_type odd = prefix_xor(zeros);
+    word_type move = odd & mask;
+    moves[i] = move;
+    mask = (mask ^ move) | (move >> (std::size_t(1) << i));
+    zeros &= ~odd;
+  }
+  return moves;
+}
+} // namespace
+
+word_type compress_word_portable(word_type data, word_type mask) {
+  std::array<word_type, ROUNDS> moves = compress_moves(mask);
+  data &= mask;
+  for (std::size_t i = 0; i < ROUNDS; ++i) {
+    word_type moved = data & moves[i];
+    data = (data ^ moved) | (moved >> (std::size_t(1) << i));
+  }
+  return data;
+}
+
+word_type expand_word_portable(word_type data, word_type mask) {
+  std::array<word_type, ROUNDS> moves = compress_moves(mask);
+  for (std::size_t i = ROUNDS; i-- > 0;) {
+    word_type shifted = data << (std::size_t(1) << i);
+    data = (data & ~moves[i]) | (shifted & moves[i]);
+  }
+  return data & mask;
+}
+
+word_type compress_word(word_type data, word_type mask) {
+#ifdef __BMI2__
+  return _pext_u64(data, mask);
+#else
+  return compress_word_portable(data, mask);
+#endif
+}
+
+word_type expand_word(word_type data, word_type mask) {
+#ifdef __BMI2__
+  return _pdep_u64(data, mask);
+#else
+  return expand_word_portable(data, mask);
+#endif
+}
+
+
+bitset compress(const bitset::const_view& data, const bitset::const_view& mask) {
+  bitset result(mask.count(), false);
+  bitset::view out = result;
+  // Extracted bits are collected in `pending` and stored a whole word at a time.
+  word_type pending = 0;
+  std::size_t pending_bits = 0;
+  std::size_t out_word = 0;
+  for (std::size_t n = 0; n < mask.words_number(); ++n) {
+    std::size_t bits = word_bits(mask.size(), n);
+    word_type mask_word = mask.get_word(n, bits);
+    if (mask_word == 0) {
+      continue;
+    }
+    word_type extracted = compress_word(data.get_word(n, bits), mask_word);
+    std::size_t extracted_bits = std::popcount(mask_word);
+    pending |= extracted << pending_bits;
+    pending_bits += extracted_bits;
+    if (pending_bits >= bitset_common::WORD_BITS) {
+      out.set_word(pending, out_word++);
+      pending_bits -= bitset_common::WORD_BITS;
+      pending = pending_bits == 0 ? 0 : extracted >> (extracted_bits - pending_bits);
+    }
+  }
+  out.set_word(pending, out_word, pending_bits);
+  return result;
+}
+
+bitset expand(const bitset::const_view& packed, const bitset::const_view& mask) {
+  bitset result(mask.size(), false);
+  bitset::view out = result;
+  std::size_t offset = 0;
+  for (std::size_t n = 0; n < mask.words_number(); ++n) {
+    std::size_t bits = word_bits(mask.size(), n);
+    word_type mask_word = mask.get_word(n, bits);
+    if (mask_word == 0) {
+      continue;
+    }
+    std::size_t deposited_bits = std::popcount(mask_word);
+    word_type source = packed.subview(offset, deposited_bits).get_word(0, deposited_bits);
+    out.set_word(expand_word(source, mask_word), n, bits);
+    offset += deposited_bits;
+  }
+  return result;
+}
+} // namespace bitset_compress
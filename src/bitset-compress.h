@@ -0,0 +1,30 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+
+// Bit gathering and scattering between views, the view-wide counterparts of
+// the BMI2 `pext` and `pdep` instructions. Each word of the mask is handled at
+// once; the instructions are used when the build targets BMI2 (see the
+// BITSET_ENABLE_BMI2 CMake option), word-parallel portable versions otherwise.
+namespace bitset_compress {
+// Single-word compress and expand, as pext and pdep. The portable versions are
+// the ones from Hacker's Delight: six rounds, each moving the selected bits of
+// every group right (or left) by 1, 2, 4, ..., 32 positions at once, whatever
+// the mask. They are always compiled so that both versions can be checked
+// against each other.
+bitset::word_type compress_word_portable(bitset::word_type data, bitset::word_type mask);
+bitset::word_type expand_word_portable(bitset::word_type data, bitset::word_type mask);
+bitset::word_type compress_word(bitset::word_type data, bitset::word_type mask);
+bitset::word_type expand_word(bitset::word_type data, bitset::word_type mask);
+
+// Bits of `data` at the positions set in `mask`, packed from bit 0 on. The
+// views must be of the same size; the result has `mask.count()` bits.
+bitset compress(const bitset::const_view& data, const bitset::const_view& mask);
+
+// Inverse of compress: bit `i` of `packed` is placed at the position of the
+// `i`-th set bit of `mask`, every other bit is cleared. `packed` must have at
+// least `mask.count()` bits; the result has `mask.size()` bits.
+bitset expand(const bitset::const_view& packed, const bitset::const_view& mask);
+} // namespace bitset_compress
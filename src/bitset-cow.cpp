@@ -0,0 +1,293 @@
+#include "bitset-cow.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+struct cow_bitset::chunk_data {
+  template <typename... Args>
+  explicit chunk_data(const Args&... args)
+      : bits(args...) {}
+
+  std::atomic<std::size_t> owners = 1;
+  // Written only by the unique owner, and read by copies made from it.
+  bool shareable = true;
+  bitset bits;
+};
+
+cow_bitset::chunk_ptr::chunk_ptr(std::size_t size, bool value)
+    : data_(new chunk_data(size, value)) {}
+
+cow_bitset::chunk_ptr::chunk_ptr(const const_view& bits)
+    : data_(new chunk_data(bits)) {}
+
+// A new owner is only made from an existing one, which keeps the chunk alive,
+// so the increment needs no ordering.
+cow_bitset::chunk_ptr::chunk_ptr(const chunk_ptr& other) noexcept
+    : data_(other.data_) {
+  data_->owners.fetch_add(1, std::memory_order_relaxed);
+}
+
+cow_bitset::chunk_ptr::chunk_ptr(chunk_ptr&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)) {}
+
+cow_bitset::chunk_ptr& cow_bitset::chunk_ptr::operator=(chunk_ptr other) noexcept {
+  std::swap(data_, other.data_);
+  return *this;
+}
+
+// The release half publishes this owner's reads and writes to whoever sees the
+// count drop next; the acquire half lets the last owner free the chunk safely.
+cow_bitset::chunk_ptr::~chunk_ptr() {
+  if (data_ != nullptr && data_->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete data_;
+  }
+}
+
+bitset& cow_bitset::chunk_ptr::operator*() const {
+  return data_->bits;
+}
+
+bitset* cow_bitset::chunk_ptr::operator->() const {
+  return &data_->bits;
+}
+
+bool cow_bitset::chunk_ptr::unique() const {
+  return data_->owners.load(std::memory_order_acquire) == 1;
+}
+
+bool cow_bitset::chunk_ptr::shareable() const {
+  return data_->shareable;
+}
+
+void cow_bitset::chunk_ptr::mark_unshareable() const {
+  data_->shareable = false;
+}
+
+cow_bitset::cow_bitset(std::size_t size, bool value)
+    : size_(size) {
+  chunks_.reserve(chunks());
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    chunks_.emplace_back(chunk_size(i), value);
+  }
+}
+
+cow_bitset::cow_bitset(const const_view& bits)
+    : size_(bits.size()) {
+  chunks_.reserve(chunks());
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    chunks_.emplace_back(bits.subview(i * CHUNK_BITS, chunk_size(i)));
+  }
+}
+
+cow_bitset::cow_bitset(const cow_bitset& other)
+    : size_(other.size_) {
+  chunks_.reserve(other.chunks_.size());
+  for (const chunk_ptr& chunk : other.chunks_) {
+    if (chunk.shareable()) {
+      chunks_.push_back(chunk);
+    } else {
+      chunks_.emplace_back(std::as_const(*chunk).subview());
+    }
+  }
+}
+
+cow_bitset& cow_bitset::operator=(const cow_bitset& other) {
+  cow_bitset(other).swap(*this);
+  return *this;
+}
+
+void cow_bitset::swap(cow_bitset& other) noexcept {
+  std::swap(size_, other.size_);
+  chunks_.swap(other.chunks_);
+}
+
+std::size_t cow_bitset::size() const {
+  return size_;
+}
+
+bool cow_bitset::empty() const {
+  return size() == 0;
+}
+
+cow_bitset::reference cow_bitset::operator[](std::size_t index) {
+  return leaked(index / CHUNK_BITS)[index % CHUNK_BITS];
+}
+
+bool cow_bitset::operator[](std::size_t index) const {
+  return std::as_const(*chunks_[index / CHUNK_BITS])[index % CHUNK_BITS];
+}
+
+std::size_t cow_bitset::chunks() const {
+  return (size() + CHUNK_BITS - 1) / CHUNK_BITS;
+}
+
+cow_bitset::const_view cow_bitset::chunk(std::size_t index) const {
+  return std::as_const(*chunks_[index]).subview();
+}
+
+cow_bitset::view cow_bitset::mutable_chunk(std::size_t index) {
+  return leaked(index).subview();
+}
+
+bool cow_bitset::shared(std::size_t index) const {
+  return !chunks_[index].unique();
+}
+
+std::size_t cow_bitset::chunk_size(std::size_t index) const {
+  return std::min(CHUNK_BITS, size() - index * CHUNK_BITS);
+}
+
+bitset& cow_bitset::writable(std::size_t index) {
+  chunk_ptr& chunk = chunks_[index];
+  if (!chunk.unique()) {
+    chunk = chunk_ptr(*chunk);
+  }
+  return *chunk;
+}
+
+// Like writable(), for a chunk whose storage escapes through a mutable
+// reference or view.
+bitset& cow_bitset::leaked(std::size_t index) {
+  bitset& bits = writable(index);
+  chunks_[index].mark_unshareable();
+  return bits;
+}
+
+// Applies `op` to chunk `index` and the matching part of `other`, unless `skip`
+// tells that this part cannot change the chunk.
+template <typename Skip, typename Op>
+void cow_bitset::combine(std::size_t index, const const_view& other, Skip skip, Op op) {
+  const_view part = other.subview(index * CHUNK_BITS, chunk_size(index));
+  if (!skip(part)) {
+    op(writable(index).subview(), part);
+  }
+}
+
+cow_bitset& cow_bitset::operator&=(const const_view& other) & {
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    combine(
+        i,
+        other,
+        [](const const_view& part) { return part.all(); },
+        [](const view& lhs, const const_view& rhs) { lhs &= rhs; }
+    );
+  }
+  return *this;
+}
+
+cow_bitset& cow_bitset::operator|=(const const_view& other) & {
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    combine(
+        i,
+        other,
+        [](const const_view& part) { return !part.any(); },
+        [](const view& lhs, const const_view& rhs) { lhs |= rhs; }
+    );
+  }
+  return *this;
+}
+
+cow_bitset& cow_bitset::operator^=(const const_view& other) & {
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    combine(
+        i,
+        other,
+        [](const const_view& part) { return !part.any(); },
+        [](const view& lhs, const const_view& rhs) { lhs ^= rhs; }
+    );
+  }
+  return *this;
+}
+
+// Chunks shared between both operands are already equal: x & x and x | x keep
+// them as they are, and x ^ x is a fresh zero chunk.
+cow_bitset& cow_bitset::operator&=(const cow_bitset& other) & {
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    if (chunks_[i] != other.chunks_[i]) {
+      writable(i) &= *other.chunks_[i];
+    }
+  }
+  return *this;
+}
+
+cow_bitset& cow_bitset::operator|=(const cow_bitset& other) & {
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    if (chunks_[i] != other.chunks_[i]) {
+      writable(i) |= *other.chunks_[i];
+    }
+  }
+  return *this;
+}
+
+cow_bitset& cow_bitset::operator^=(const cow_bitset& other) & {
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    if (chunks_[i] == other.chunks_[i]) {
+      chunks_[i] = chunk_ptr(chunk_size(i), false);
+    } else {
+      writable(i) ^= *other.chunks_[i];
+    }
+  }
+  return *this;
+}
+
+cow_bitset& cow_bitset::flip() & {
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    writable(i).flip();
+  }
+  return *this;
+}
+
+cow_bitset& cow_bitset::set() & {
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    chunks_[i] = chunk_ptr(chunk_size(i), true);
+  }
+  return *this;
+}
+
+cow_bitset& cow_bitset::reset() & {
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    chunks_[i] = chunk_ptr(chunk_size(i), false);
+  }
+  return *this;
+}
+
+bool cow_bitset::all() const {
+  return std::ranges::all_of(chunks_, [](const chunk_ptr& chunk) { return chunk->all(); });
+}
+
+bool cow_bitset::any() const {
+  return std::ranges::any_of(chunks_, [](const chunk_ptr& chunk) { return chunk->any(); });
+}
+
+std::size_t cow_bitset::count() const {
+  std::size_t result = 0;
+  for (const chunk_ptr& chunk : chunks_) {
+    result += chunk->count();
+  }
+  return result;
+}
+
+bitset cow_bitset::to_bitset() const {
+  bitset result(size(), false);
+  for (std::size_t i = 0; i < chunks(); ++i) {
+    result.subview(i * CHUNK_BITS, chunk_size(i)).assign(*chunks_[i]);
+  }
+  return result;
+}
+
+bool operator==(const cow_bitset& lhs, const cow_bitset& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < lhs.chunks(); ++i) {
+    if (lhs.chunks_[i] != rhs.chunks_[i] && *lhs.chunks_[i] != *rhs.chunks_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void swap(cow_bitset& lhs, cow_bitset& rhs) noexcept {
+  lhs.swap(rhs);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <vector>
+
+// Bitset whose copies share storage. Bits are kept in chunks of CHUNK_BITS,
+// each a reference-counted bitset; copying only copies the chunk pointers, and
+// a chunk is duplicated on the first mutation through a copy that shares it.
+// Chunks are ordinary bitsets, so each can be handed out as a view.
+//
+// A chunk that has handed out a mutable reference or view is never shared
+// again: copies deep-copy it, so writes through the reference cannot reach
+// them. It becomes shareable once set() or reset() replace it.
+//
+// Like std::shared_ptr, distinct copies may be read, written, copied and
+// destroyed on different threads at once even while they share chunks; a
+// single object must not be written while it is used on another thread.
+class cow_bitset {
+public:
+  using reference = bitset::reference;
+  using view = bitset::view;
+  using const_view = bitset::const_view;
+
+  // 32 KiB per chunk.
+  static constexpr std::size_t CHUNK_BITS = std::size_t(1) << 18;
+
+  cow_bitset() = default;
+  cow_bitset(std::size_t size, bool value);
+  explicit cow_bitset(const const_view& bits);
+  cow_bitset(const cow_bitset& other);
+  cow_bitset(cow_bitset&& other) noexcept = default;
+  cow_bitset& operator=(const cow_bitset& other);
+  cow_bitset& operator=(cow_bitset&& other) noexcept = default;
+
+  void swap(cow_bitset& other) noexcept;
+
+  std::size_t size() const;
+  bool empty() const;
+
+  // Unshares the chunk holding `index` and keeps it from being shared again.
+  reference operator[](std::size_t index);
+  bool operator[](std::size_t index) const;
+
+  std::size_t chunks() const;
+  const_view chunk(std::size_t index) const;
+  // Unshares the chunk and keeps it from being shared again.
+  view mutable_chunk(std::size_t index);
+  // Whether the chunk's storage is shared with another copy. With copies on
+  // other threads this is only a snapshot.
+  bool shared(std::size_t index) const;
+
+  // Chunks the operation would leave unchanged stay shared.
+  cow_bitset& operator&=(const const_view& other) &;
+  cow_bitset& operator|=(const const_view& other) &;
+  cow_bitset& operator^=(const const_view& other) &;
+  cow_bitset& operator&=(const cow_bitset& other) &;
+  cow_bitset& operator|=(const cow_bitset& other) &;
+  cow_bitset& operator^=(const cow_bitset& other) &;
+  cow_bitset& flip() &;
+
+  // Replace every chunk with a fresh one instead of copying.
+  cow_bitset& set() &;
+  cow_bitset& reset() &;
+
+  bool all() const;
+  bool any() const;
+  std::size_t count() const;
+
+  bitset to_bitset() const;
+
+  friend bool operator==(const cow_bitset& lhs, const cow_bitset& rhs);
+
+private:
+  struct chunk_data;
+
+  // Owning handle to a chunk with an atomic count of the handles sharing it.
+  // Unlike std::shared_ptr::use_count(), unique() is an acquire load, so the
+  // writes that follow it are ordered after the last reads of the chunk by
+  // owners that dropped it on other threads.
+  class chunk_ptr {
+  public:
+    chunk_ptr(std::size_t size, bool value);
+    explicit chunk_ptr(const const_view& bits);
+    chunk_ptr(const chunk_ptr& other) noexcept;
+    chunk_ptr(chunk_ptr&& other) noexcept;
+    chunk_ptr& operator=(chunk_ptr other) noexcept;
+    ~chunk_ptr();
+
+    bitset& operator*() const;
+    bitset* operator->() const;
+    bool unique() const;
+    // Only the unique owner may mark a chunk; copies of cow_bitset then
+    // deep-copy it instead of sharing it.
+    bool shareable() const;
+    void mark_unshareable() const;
+
+    friend bool operator==(const chunk_ptr&, const chunk_ptr&) = default;
+
+  private:
+    chunk_data* data_;
+  };
+
+  std::size_t chunk_size(std::size_t index) const;
+  bitset& writable(std::size_t index);
+  bitset& leaked(std::size_t index);
+
+  template <typename Skip, typename Op>
+  void combine(std::size_t index, const const_view& other, Skip skip, Op op);
+
+private:
+  std::size_t size_ = 0;
+  std::vector<chunk_ptr> chunks_;
+};
+
+void swap(cow_bitset& lhs, cow_bitset& rhs) noexcept;
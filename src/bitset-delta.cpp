@@ -0,0 +1,192 @@
+#include "bitset-delta.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace bitset_delta {
+namespace {
+using word_type = bitset::word_type;
+
+// Every encoded word or run starts with a varint holding the number of unchanged
+// words skipped before it, shifted left by two, and its kind in the low bits.
+enum kind : uint64_t {
+  sparse = 0,  // a byte with the number of flipped bits, then a byte per bit index
+  literal = 1, // the XOR word itself, little-endian
+  run = 2,     // a varint count of consecutive words with every bit flipped
+};
+
+constexpr std::size_t KIND_BITS = 2;
+constexpr std::size_t MAX_SPARSE_BITS = 6;
+
+std::size_t word_bits(std::size_t size, std::size_t n) {
+  return std::min(bitset_common::WORD_BITS, size - n * bitset_common::WORD_BITS);
+}
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+  for (; value >= 0x80; value >>= 7) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+class reader {
+public:
+  explicit reader(const std::vector<uint8_t>& bytes)
+      : bytes_(bytes) {}
+
+  bool done() const {
+    return pos_ == bytes_.size();
+  }
+
+  uint8_t byte() {
+    if (done()) {
+      throw std::invalid_argument("bitset delta is truncated");
+    }
+    return bytes_[pos_++];
+  }
+
+  uint64_t varint() {
+    uint64_t result = 0;
+    for (std::size_t shift = 0; shift < 64; shift += 7) {
+      uint8_t b = byte();
+      result |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if ((b & 0x80) == 0) {
+        return result;
+      }
+    }
+    throw std::invalid_argument("bitset delta has an overlong varint");
+  }
+
+private:
+  const std::vector<uint8_t>& bytes_;
+  std::size_t pos_ = 0;
+};
+} // namespace
+
+delta diff(const bitset::const_view& before, const bitset::const_view& after) {
+  delta result;
+  result.size = after.size();
+  std::size_t words = after.words_number();
+  std::size_t skipped = 0;
+  for (std::size_t n = 0; n < words;) {
+    std::size_t bits = word_bits(result.size, n);
+    word_type x = before.get_word(n, bits) ^ after.get_word(n, bits);
+    if (x == 0) {
+      ++skipped;
+      ++n;
+      continue;
+    }
+    uint64_t header = skipped << KIND_BITS;
+    skipped = 0;
+    if (x == bitset_common::low_bits(bits)) {
+      std::size_t count = 1;
+      for (; n + count < words; ++count) {
+        std::size_t next_bits = word_bits(result.size, n + count);
+        word_type next = before.get_word(n + count, next_bits) ^ after.get_word(n + count, next_bits);
+        if (next != bitset_common::low_bits(next_bits)) {
+          break;
+        }
+      }
+      if (count > 1) {
+        put_varint(result.encoded, header | run);
+        put_varint(result.encoded, count);
+        n += count;
+        continue;
+      }
+    }
+    std::size_t flipped = std::popcount(x);
+    if (flipped <= MAX_SPARSE_BITS) {
+      put_varint(result.encoded, header | sparse);
+      result.encoded.push_back(static_cast<uint8_t>(flipped));
+      for (; x != 0; x &= x - 1) {
+        result.encoded.push_back(static_cast<uint8_t>(std::countr_zero(x)));
+      }
+    } else {
+      put_varint(result.encoded, header | literal);
+      for (std::size_t i = 0; i < sizeof(word_type); ++i) {
+        result.encoded.push_back(static_cast<uint8_t>(x >> (8 * i)));
+      }
+    }
+    ++n;
+  }
+  return result;
+}
+
+namespace {
+// Decodes `patch` against a view of `size` bits and calls visit(n, x) for every
+// word n to be flipped by x, in order. Throws on the first malformed chunk.
+template <typename Visit>
+void for_each_flip(const delta& patch, std::size_t size, Visit visit) {
+  std::size_t words = (size + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS;
+  auto flip_word = [size, words, &visit](std::size_t n, word_type x) {
+    if (n >= words) {
+      throw std::invalid_argument("bitset delta runs past the end");
+    }
+    if ((x & ~bitset_common::low_bits(word_bits(size, n))) != 0) {
+      throw std::invalid_argument("bitset delta flips bits past the end");
+    }
+    visit(n, x);
+  };
+
+  reader in(patch.encoded);
+  std::size_t n = 0;
+  while (!in.done()) {
+    uint64_t header = in.varint();
+    uint64_t skipped = header >> KIND_BITS;
+    if (skipped > words - std::min(n, words)) {
+      throw std::invalid_argument("bitset delta runs past the end");
+    }
+    n += skipped;
+    switch (header & ((1 << KIND_BITS) - 1)) {
+    case sparse: {
+      std::size_t flipped = in.byte();
+      word_type x = 0;
+      for (std::size_t i = 0; i < flipped; ++i) {
+        std::size_t bit = in.byte();
+        if (bit >= bitset_common::WORD_BITS) {
+          throw std::invalid_argument("bitset delta has a bit index out of range");
+        }
+        x |= bitset_common::ONE << bit;
+      }
+      flip_word(n++, x);
+      break;
+    }
+    case literal: {
+      word_type x = 0;
+      for (std::size_t i = 0; i < sizeof(word_type); ++i) {
+        x |= static_cast<word_type>(in.byte()) << (8 * i);
+      }
+      flip_word(n++, x);
+      break;
+    }
+    case run: {
+      uint64_t count = in.varint();
+      if (count > words - std::min(n, words)) {
+        throw std::invalid_argument("bitset delta runs past the end");
+      }
+      for (uint64_t i = 0; i < count; ++i, ++n) {
+        flip_word(n, bitset_common::low_bits(word_bits(size, n)));
+      }
+      break;
+    }
+    default:
+      throw std::invalid_argument("bitset delta has an unknown chunk kind");
+    }
+  }
+}
+} // namespace
+
+// The patch is decoded twice: a dry run validates all of it, so a malformed
+// patch throws before the target is touched, then the second pass flips.
+void apply_patch(const bitset::view& target, const delta& patch) {
+  if (patch.size != target.size()) {
+    throw std::invalid_argument("bitset delta was made for another size");
+  }
+  for_each_flip(patch, target.size(), [](std::size_t, word_type) {});
+  for_each_flip(patch, target.size(), [&target](std::size_t n, word_type x) {
+    std::size_t bits = word_bits(target.size(), n);
+    target.set_word(target.get_word(n, bits) ^ x, n, bits);
+  });
+}
+} // namespace bitset_delta
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compact encoding of the XOR of two equally sized views, for shipping changes
+// instead of snapshots. Only words that differ are encoded, each one as whichever
+// is shorter: the positions of its few changed bits, the literal word, or part of
+// a run of fully flipped words.
+namespace bitset_delta {
+struct delta {
+  std::size_t size = 0;
+  std::vector<uint8_t> encoded;
+
+  friend bool operator==(const delta&, const delta&) = default;
+};
+
+// Single pass over both views; the views must be of the same size.
+delta diff(const bitset::const_view& before, const bitset::const_view& after);
+
+// Flips the bits recorded in `patch`, turning `before` into `after` and back.
+// Throws std::invalid_argument if the patch is malformed or made for another size;
+// the target is left unchanged then.
+void apply_patch(const bitset::view& target, const delta& patch);
+} // namespace bitset_delta
@@ -0,0 +1,52 @@
+#include "bitset-dirty.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace bitset_dirty {
+tracker::tracker(const bitset_common::word_type* base, std::size_t words)
+    : base_(base)
+    , summary_((words + BLOCK_BITS - 1) / BLOCK_BITS, bitset_common::ZERO) {
+  std::size_t blocks = (words + BLOCK_WORDS - 1) / BLOCK_WORDS;
+  for (std::size_t block = 0; block < blocks; ++block) {
+    summary_[block / bitset_common::WORD_BITS] |= bitset_common::ONE << (block % bitset_common::WORD_BITS);
+  }
+}
+
+void tracker::mark(const bitset_common::word_type* first, std::size_t words) {
+  if (words == 0) {
+    return;
+  }
+  for (std::size_t offset = 0; offset < words; offset += BLOCK_WORDS) {
+    mark(first + offset);
+  }
+  mark(first + words - 1);
+}
+
+std::vector<range> tracker::ranges(std::size_t size) const {
+  std::vector<range> result;
+  for (std::size_t n = 0; n < summary_.size(); ++n) {
+    for (bitset_common::word_type word = summary_[n]; word != 0; word &= word - 1) {
+      std::size_t offset = (n * bitset_common::WORD_BITS + std::countr_zero(word)) * BLOCK_BITS;
+      if (offset >= size) {
+        return result;
+      }
+      std::size_t length = std::min(BLOCK_BITS, size - offset);
+      if (!result.empty() && result.back().offset + result.back().size == offset) {
+        result.back().size += length;
+      } else {
+        result.push_back({offset, length});
+      }
+    }
+  }
+  return result;
+}
+
+bool tracker::any() const {
+  return std::ranges::any_of(summary_, [](bitset_common::word_type word) { return word != 0; });
+}
+
+void tracker::clear() {
+  std::ranges::fill(summary_, bitset_common::ZERO);
+}
+} // namespace bitset_dirty
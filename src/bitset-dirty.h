@@ -0,0 +1,53 @@
+#pragma once
+
+#include "bitset-common.h"
+
+#include <cstddef>
+#include <vector>
+
+// Dirty-region tracking for incremental replication. It exists only when the
+// library is compiled with BITSET_ENABLE_DIRTY_TRACKING: iterators, references
+// and views then carry a pointer to the tracker of their bitset, and every store
+// into the bitset's words also sets the block's bit in a summary bitmap. Without
+// the flag none of the members below are added and stores are untouched.
+namespace bitset_dirty {
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+static constexpr bool enabled = true;
+#else
+static constexpr bool enabled = false;
+#endif
+
+// One summary bit covers a 4 KiB block of words.
+static constexpr std::size_t BLOCK_WORDS = 512;
+static constexpr std::size_t BLOCK_BITS = BLOCK_WORDS * bitset_common::WORD_BITS;
+
+// Bits [offset, offset + size) of a bitset.
+struct range {
+  std::size_t offset;
+  std::size_t size;
+
+  friend bool operator==(const range&, const range&) = default;
+};
+
+class tracker {
+public:
+  // Tracks `words` words starting at `base`, all of them initially dirty.
+  tracker(const bitset_common::word_type* base, std::size_t words);
+
+  void mark(const bitset_common::word_type* word) {
+    std::size_t block = (word - base_) / BLOCK_WORDS;
+    summary_[block / bitset_common::WORD_BITS] |= bitset_common::ONE << (block % bitset_common::WORD_BITS);
+  }
+
+  void mark(const bitset_common::word_type* first, std::size_t words);
+
+  // Maximal runs of dirty blocks, clipped to the first `size` bits.
+  std::vector<range> ranges(std::size_t size) const;
+  bool any() const;
+  void clear();
+
+private:
+  const bitset_common::word_type* base_;
+  std::vector<bitset_common::word_type> summary_;
+};
+} // namespace bitset_dirty
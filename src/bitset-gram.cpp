@@ -0,0 +1,113 @@
+#include "bitset-gram.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <thread>
+
+namespace bitset_gram {
+namespace {
+using word_type = bitset::word_type;
+using block = std::array<word_type, BLOCK_WORDS>;
+
+struct tile {
+  std::size_t first_lhs;
+  std::size_t first_rhs;
+};
+
+// Copies words [first, first + words) of each view of a tile into `blocks`.
+void load_blocks(
+    std::span<const bitset::const_view> views,
+    std::size_t first,
+    std::size_t words,
+    std::array<block, TILE_VIEWS>& blocks
+) {
+  for (std::size_t v = 0; v < views.size(); ++v) {
+    const bitset::const_view& view = views[v];
+    for (std::size_t n = 0; n < words; ++n) {
+      std::size_t bits = std::min(bitset_common::WORD_BITS, view.size() - (first + n) * bitset_common::WORD_BITS);
+      blocks[v][n] = view.get_word(first + n, bits);
+    }
+  }
+}
+
+void count_tile(
+    std::span<const bitset::const_view> lhs,
+    std::span<const bitset::const_view> rhs,
+    std::span<std::size_t> out,
+    std::size_t columns,
+    const tile& t
+) {
+  auto lhs_tile = lhs.subspan(t.first_lhs, std::min(TILE_VIEWS, lhs.size() - t.first_lhs));
+  auto rhs_tile = rhs.subspan(t.first_rhs, std::min(TILE_VIEWS, rhs.size() - t.first_rhs));
+  std::array<std::array<std::size_t, TILE_VIEWS>, TILE_VIEWS> counts{};
+  std::array<block, TILE_VIEWS> lhs_blocks;
+  std::array<block, TILE_VIEWS> rhs_blocks;
+  std::size_t total_words = lhs_tile.front().words_number();
+  for (std::size_t first = 0; first < total_words; first += BLOCK_WORDS) {
+    std::size_t words = std::min(BLOCK_WORDS, total_words - first);
+    load_blocks(lhs_tile, first, words, lhs_blocks);
+    load_blocks(rhs_tile, first, words, rhs_blocks);
+    for (std::size_t i = 0; i < lhs_tile.size(); ++i) {
+      for (std::size_t j = 0; j < rhs_tile.size(); ++j) {
+        std::size_t count = 0;
+        for (std::size_t n = 0; n < words; ++n) {
+          count += std::popcount(lhs_blocks[i][n] & rhs_blocks[j][n]);
+        }
+        counts[i][j] += count;
+      }
+    }
+  }
+  for (std::size_t i = 0; i < lhs_tile.size(); ++i) {
+    for (std::size_t j = 0; j < rhs_tile.size(); ++j) {
+      out[(t.first_lhs + i) * columns + t.first_rhs + j] = counts[i][j];
+    }
+  }
+}
+} // namespace
+
+void intersection_counts(
+    std::span<const bitset::const_view> lhs,
+    std::span<const bitset::const_view> rhs,
+    std::span<std::size_t> out,
+    std::size_t threads
+) {
+  std::vector<tile> tiles;
+  for (std::size_t i = 0; i < lhs.size(); i += TILE_VIEWS) {
+    for (std::size_t j = 0; j < rhs.size(); j += TILE_VIEWS) {
+      tiles.push_back({i, j});
+    }
+  }
+  threads = std::min(threads, tiles.size());
+  if (threads <= 1) {
+    for (const tile& t : tiles) {
+      count_tile(lhs, rhs, out, rhs.size(), t);
+    }
+    return;
+  }
+  // Tiles write disjoint parts of `out`; workers just take the next one.
+  std::atomic<std::size_t> next = 0;
+  auto work = [&]() {
+    for (std::size_t t = next++; t < tiles.size(); t = next++) {
+      count_tile(lhs, rhs, out, rhs.size(), tiles[t]);
+    }
+  };
+  std::vector<std::jthread> workers;
+  workers.reserve(threads - 1);
+  for (std::size_t i = 1; i < threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+}
+
+std::vector<std::size_t> intersection_counts(
+    std::span<const bitset::const_view> lhs,
+    std::span<const bitset::const_view> rhs,
+    std::size_t threads
+) {
+  std::vector<std::size_t> result(lhs.size() * rhs.size());
+  intersection_counts(lhs, rhs, result, threads);
+  return result;
+}
+} // namespace bitset_gram
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// All-pairs intersection counts between two collections of equally sized views.
+// Pairs are processed in tiles of TILE_VIEWS x TILE_VIEWS and the words in blocks
+// of BLOCK_WORDS, so a block of every view of a tile is loaded once and reused
+// for all the pairs in the tile. Tiles are independent and can be spread over
+// threads.
+namespace bitset_gram {
+static constexpr std::size_t TILE_VIEWS = 8;
+static constexpr std::size_t BLOCK_WORDS = 256;
+
+// Fills the row-major lhs.size() x rhs.size() matrix `out` with
+// `and_count(lhs[i], rhs[j])`, using up to `threads` threads.
+void intersection_counts(
+    std::span<const bitset::const_view> lhs,
+    std::span<const bitset::const_view> rhs,
+    std::span<std::size_t> out,
+    std::size_t threads = 1
+);
+
+std::vector<std::size_t> intersection_counts(
+    std::span<const bitset::const_view> lhs,
+    std::span<const bitset::const_view> rhs,
+    std::size_t threads = 1
+);
+} // namespace bitset_gram
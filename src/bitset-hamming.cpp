@@ -0,0 +1,179 @@
+#include "bitset-hamming.h"
+
+#include "bitset-simd.h"
+
+#include <algorithm>
+#include <queue>
+
+namespace {
+using word_type = bitset::word_type;
+
+// A row's partial distance is checked against the bound once per this many words.
+constexpr std::size_t BOUND_CHECK_WORDS = 8;
+
+std::size_t words_for(std::size_t bits) {
+  return (bits + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS;
+}
+
+// Distance between the rows, or any value above `bound` once it is known to exceed it.
+std::size_t bounded_xor_count(const word_type* lhs, const word_type* rhs, std::size_t words, std::size_t bound) {
+  std::size_t result = 0;
+  for (std::size_t first = 0; first < words; first += BOUND_CHECK_WORDS) {
+    result += bitset_simd::xor_count(lhs + first, rhs + first, std::min(BOUND_CHECK_WORDS, words - first));
+    if (result > bound) {
+      break;
+    }
+  }
+  return result;
+}
+
+bool closer(const hamming_index::match& lhs, const hamming_index::match& rhs) {
+  return lhs.distance != rhs.distance ? lhs.distance < rhs.distance : lhs.index < rhs.index;
+}
+} // namespace
+
+hamming_index::hamming_index(std::size_t bits)
+    : bits_(bits)
+    , stride_(words_for(bits))
+    , size_(0) {}
+
+void hamming_index::swap(hamming_index& other) noexcept {
+  std::swap(bits_, other.bits_);
+  std::swap(stride_, other.stride_);
+  std::swap(size_, other.size_);
+  rows_.swap(other.rows_);
+}
+
+std::size_t hamming_index::bits() const {
+  return bits_;
+}
+
+std::size_t hamming_index::size() const {
+  return size_;
+}
+
+bool hamming_index::empty() const {
+  return size() == 0;
+}
+
+std::size_t hamming_index::add(const const_view& signature) {
+  std::size_t row_bits = stride_ * bitset_common::WORD_BITS;
+  if ((size_ + 1) * row_bits > rows_.size()) {
+    reserve_rows(std::max<std::size_t>(2 * size_, 16));
+  }
+  rows_.subview(size_ * row_bits, bits_).assign(signature);
+  return size_++;
+}
+
+hamming_index::const_view hamming_index::signature(std::size_t index) const {
+  return rows_.subview(index * stride_ * bitset_common::WORD_BITS, bits_);
+}
+
+std::size_t hamming_index::distance(const const_view& query, std::size_t index) const {
+  std::vector<word_type> q = load_query(query);
+  return bitset_simd::xor_count(q.data(), row_data(index), stride_);
+}
+
+void hamming_index::distances(const const_view& query, std::span<std::size_t> out) const {
+  std::vector<word_type> q = load_query(query);
+  for (std::size_t i = 0; i < size_; ++i) {
+    out[i] = bitset_simd::xor_count(q.data(), row_data(i), stride_);
+  }
+}
+
+void hamming_index::distances(
+    const const_view& query,
+    std::span<const uint32_t> candidates,
+    std::span<std::size_t> out
+) const {
+  std::vector<word_type> q = load_query(query);
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    out[i] = bitset_simd::xor_count(q.data(), row_data(candidates[i]), stride_);
+  }
+}
+
+std::vector<hamming_index::match> hamming_index::top_k(
+    const const_view& query,
+    std::size_t k,
+    std::size_t max_distance
+) const {
+  return select(load_query(query), [](std::size_t i) { return i; }, size_, k, max_distance);
+}
+
+std::vector<hamming_index::match> hamming_index::top_k(
+    const const_view& query,
+    std::span<const uint32_t> candidates,
+    std::size_t k,
+    std::size_t max_distance
+) const {
+  return select(
+      load_query(query),
+      [candidates](std::size_t i) { return std::size_t(candidates[i]); },
+      candidates.size(),
+      k,
+      max_distance
+  );
+}
+
+// Keeps the best `k` matches in a max-heap; once it is full, its worst distance
+// becomes the bound for the remaining rows.
+template <typename Index>
+std::vector<hamming_index::match> hamming_index::select(
+    const std::vector<word_type>& query,
+    Index index_of,
+    std::size_t count,
+    std::size_t k,
+    std::size_t max_distance
+) const {
+  std::priority_queue<match, std::vector<match>, decltype(&closer)> heap(&closer);
+  if (k == 0) {
+    return {};
+  }
+  std::size_t bound = max_distance;
+  for (std::size_t i = 0; i < count; ++i) {
+    std::size_t index = index_of(i);
+    std::size_t d = bounded_xor_count(query.data(), row_data(index), stride_, bound);
+    if (d > bound) {
+      continue;
+    }
+    match m{index, d};
+    if (heap.size() == k) {
+      if (!closer(m, heap.top())) {
+        continue;
+      }
+      heap.pop();
+    }
+    heap.push(m);
+    if (heap.size() == k) {
+      bound = std::min(bound, heap.top().distance);
+    }
+  }
+  std::vector<match> result(heap.size());
+  for (std::size_t i = result.size(); i-- > 0;) {
+    result[i] = heap.top();
+    heap.pop();
+  }
+  return result;
+}
+
+const word_type* hamming_index::row_data(std::size_t index) const {
+  return rows_.data() + index * stride_;
+}
+
+std::vector<word_type> hamming_index::load_query(const const_view& query) const {
+  std::vector<word_type> result(stride_);
+  for (std::size_t n = 0; n < stride_; ++n) {
+    result[n] = query.get_word(n, std::min(bitset_common::WORD_BITS, bits_ - n * bitset_common::WORD_BITS));
+  }
+  return result;
+}
+
+void hamming_index::reserve_rows(std::size_t rows) {
+  bitset grown(rows * stride_ * bitset_common::WORD_BITS, false);
+  grown.subview(0, rows_.size()).assign(rows_);
+  rows_.swap(grown);
+}
+
+void swap(hamming_index& lhs, hamming_index& rhs) noexcept {
+  lhs.swap(rhs);
+}
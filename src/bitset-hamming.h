@@ -0,0 +1,79 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Equally sized signatures stored back to back, each starting on a word
+// boundary of a single bitset, for one-to-many Hamming distance queries. A
+// query is copied once into aligned words and compared against the rows with
+// the XOR and popcount kernel bitset_simd::xor_count.
+class hamming_index {
+public:
+  using word_type = bitset::word_type;
+  using const_view = bitset::const_view;
+
+  static constexpr std::size_t npos = -1;
+
+  struct match {
+    std::size_t index;
+    std::size_t distance;
+
+    friend bool operator==(const match&, const match&) = default;
+  };
+
+  explicit hamming_index(std::size_t bits);
+
+  void swap(hamming_index& other) noexcept;
+
+  // Length of every signature.
+  std::size_t bits() const;
+  // Number of signatures.
+  std::size_t size() const;
+  bool empty() const;
+
+  // Appends a signature of bits() bits and returns its index.
+  std::size_t add(const const_view& signature);
+  const_view signature(std::size_t index) const;
+
+  std::size_t distance(const const_view& query, std::size_t index) const;
+  // out[i] is the distance to signature i, or to signature candidates[i].
+  void distances(const const_view& query, std::span<std::size_t> out) const;
+  void distances(const const_view& query, std::span<const uint32_t> candidates, std::span<std::size_t> out) const;
+
+  // The `k` signatures closest to `query` with a distance of at most
+  // `max_distance`, ordered by distance and then by index. Rows are abandoned as
+  // soon as their partial distance exceeds the current k-th best.
+  std::vector<match> top_k(const const_view& query, std::size_t k, std::size_t max_distance = npos) const;
+  std::vector<match> top_k(
+      const const_view& query,
+      std::span<const uint32_t> candidates,
+      std::size_t k,
+      std::size_t max_distance = npos
+  ) const;
+
+private:
+  const word_type* row_data(std::size_t index) const;
+  std::vector<word_type> load_query(const const_view& query) const;
+  void reserve_rows(std::size_t rows);
+
+  template <typename Index>
+  std::vector<match> select(
+      const std::vector<word_type>& query,
+      Index index_of,
+      std::size_t count,
+      std::size_t k,
+      std::size_t max_distance
+  ) const;
+
+private:
+  std::size_t bits_;
+  std::size_t stride_;
+  std::size_t size_;
+  bitset rows_;
+};
+
+void swap(hamming_index& lhs, hamming_index& rhs) noexcept;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bitset-common.h"
+#include "bitset-dirty.h"
 #include "bitset-reference.h"
 
 #include <cmath>
@@ -8,6 +9,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <type_traits>
 
 using word_type = uint64_t;
 
@@ -20,26 +22,33 @@ public:
   using pointer = void;
   using iterator_category = std::random_access_iterator_tag;
 
-  bitset_iterator() = default;
+  constexpr bitset_iterator() = default;
 
-  operator bitset_iterator<const T>() const {
+  constexpr operator bitset_iterator<const T>() const {
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+    return {word_ptr_, bit_index_, dirty_};
+#else
     return {word_ptr_, bit_index_};
+#endif
   }
 
-  void swap(bitset_iterator& other) noexcept {
+  constexpr void swap(bitset_iterator& other) noexcept {
     std::swap(word_ptr_, other.word_ptr_);
     std::swap(bit_index_, other.bit_index_);
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+    std::swap(dirty_, other.dirty_);
+#endif
   }
 
-  reference operator*() const {
-    return reference(word_ptr_, bit_index_);
+  constexpr reference operator*() const {
+    return makeReference(bit_index_);
   }
 
-  reference operator[](difference_type index) const {
-    return reference(word_ptr_, bit_index_ + index);
+  constexpr reference operator[](difference_type index) const {
+    return makeReference(bit_index_ + index);
   }
 
-  bitset_iterator& operator++() {
+  constexpr bitset_iterator& operator++() {
     if (bit_index_ + 1 == bitset_common::WORD_BITS) {
       bit_index_ = 0;
       ++word_ptr_;
@@ -49,13 +58,13 @@ public:
     return *this;
   }
 
-  bitset_iterator operator++(int) {
+  constexpr bitset_iterator operator++(int) {
     bitset_iterator copy = *this;
     ++*this;
     return copy;
   }
 
-  bitset_iterator& operator--() {
+  constexpr bitset_iterator& operator--() {
     if (bit_index_ == 0) {
       bit_index_ = bitset_common::WORD_BITS - 1;
       --word_ptr_;
@@ -65,51 +74,49 @@ public:
     return *this;
   }
 
-  bitset_iterator operator--(int) {
+  constexpr bitset_iterator operator--(int) {
     bitset_iterator copy = *this;
     --*this;
     return copy;
   }
 
-  bitset_iterator& operator+=(const difference_type n) {
-    bitset_iterator<T> tmp(word_ptr_, bit_index_ + n);
-    swap(tmp);
+  constexpr bitset_iterator& operator+=(const difference_type n) {
+    word_ptr_ = calc_word(word_ptr_, bit_index_ + n);
+    bit_index_ = (bit_index_ + n) % bitset_common::WORD_BITS;
     return *this;
   }
 
-  bitset_iterator& operator-=(const difference_type n) {
-    bitset_iterator tmp(word_ptr_, bit_index_ - n);
-    swap(tmp);
-    return *this;
+  constexpr bitset_iterator& operator-=(const difference_type n) {
+    return *this += -n;
   }
 
-  friend bitset_iterator operator+(const difference_type lhs, const bitset_iterator& rhs) {
+  friend constexpr bitset_iterator operator+(const difference_type lhs, const bitset_iterator& rhs) {
     bitset_iterator result = rhs;
     return (result += lhs);
   }
 
-  friend bitset_iterator operator+(const bitset_iterator& lhs, const difference_type rhs) {
+  friend constexpr bitset_iterator operator+(const bitset_iterator& lhs, const difference_type rhs) {
     return rhs + lhs;
   }
 
-  friend bitset_iterator operator-(const difference_type lhs, const bitset_iterator& rhs) {
+  friend constexpr bitset_iterator operator-(const difference_type lhs, const bitset_iterator& rhs) {
     return -(rhs - lhs);
   }
 
-  friend bitset_iterator operator-(const bitset_iterator& lhs, const difference_type rhs) {
+  friend constexpr bitset_iterator operator-(const bitset_iterator& lhs, const difference_type rhs) {
     bitset_iterator result = lhs;
     return (result -= rhs);
   }
 
-  friend difference_type operator-(const bitset_iterator& lhs, const bitset_iterator& rhs) {
+  friend constexpr difference_type operator-(const bitset_iterator& lhs, const bitset_iterator& rhs) {
     return (lhs.word_ptr_ - rhs.word_ptr_) * bitset_common::WORD_BITS + (lhs.bit_index_ - rhs.bit_index_);
   }
 
-  friend bool operator==(const bitset_iterator& lhs, const bitset_iterator& rhs) {
+  friend constexpr bool operator==(const bitset_iterator& lhs, const bitset_iterator& rhs) {
     return lhs.word_ptr_ == rhs.word_ptr_ && lhs.bit_index_ == rhs.bit_index_;
   }
 
-  friend std::strong_ordering operator<=>(const bitset_iterator& lhs, const bitset_iterator& rhs) {
+  friend constexpr std::strong_ordering operator<=>(const bitset_iterator& lhs, const bitset_iterator& rhs) {
     if (lhs.word_ptr_ == rhs.word_ptr_) {
       return lhs.bit_index_ <=> rhs.bit_index_;
     } else {
@@ -117,7 +124,7 @@ public:
     }
   }
 
-  word_type get_word(std::size_t word_num = 0, std::size_t max_bits = bitset_common::WORD_BITS) {
+  constexpr word_type get_word(std::size_t word_num = 0, std::size_t max_bits = bitset_common::WORD_BITS) {
     word_type result = word(word_num) >> bit_index();
     std::size_t curr_size = bitset_common::WORD_BITS - bit_index();
     if (curr_size < max_bits) {
@@ -131,11 +138,43 @@ public:
   }
 
 private:
-  bitset_iterator(T* data_, difference_type bit_index)
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+  constexpr bitset_iterator(T* data_, difference_type bit_index, bitset_dirty::tracker* dirty)
+      : word_ptr_(calc_word(data_, bit_index))
+      , bit_index_(bit_index % bitset_common::WORD_BITS)
+      , dirty_(dirty) {}
+
+  constexpr reference makeReference(std::size_t bit_index) const {
+    return reference(word_ptr_, bit_index, dirty_);
+  }
+
+  // Trackers only exist at run time; see bitset_dirty.
+  constexpr void markDirty(const T* word) const {
+    if (!std::is_constant_evaluated()) {
+      dirty_->mark(word);
+    }
+  }
+
+  constexpr void markDirty(const T* first, std::size_t words) const {
+    if (!std::is_constant_evaluated()) {
+      dirty_->mark(first, words);
+    }
+  }
+#else
+  constexpr bitset_iterator(T* data_, difference_type bit_index)
       : word_ptr_(calc_word(data_, bit_index))
       , bit_index_(bit_index % bitset_common::WORD_BITS) {}
 
-  T* calc_word(T* cur_word, difference_type bit_index) const {
+  constexpr reference makeReference(std::size_t bit_index) const {
+    return reference(word_ptr_, bit_index);
+  }
+
+  constexpr void markDirty(const T*) const {}
+
+  constexpr void markDirty(const T*, std::size_t) const {}
+#endif
+
+  constexpr T* calc_word(T* cur_word, difference_type bit_index) const {
     T* result = cur_word + (bit_index / static_cast<difference_type>(bitset_common::WORD_BITS));
     if (bit_index < 0 && bit_index % bitset_common::WORD_BITS != 0) {
       --result;
@@ -143,22 +182,24 @@ private:
     return result;
   }
 
-  std::size_t bit_index() {
+  constexpr std::size_t bit_index() {
     return bit_index_;
   }
 
   template <bitset_common::NonConst U = T>
-  void set_word(word_type value, std::size_t word_num = 0, std::size_t bits = bitset_common::WORD_BITS) {
+  constexpr void
+  set_word(word_type value, std::size_t word_num = 0, std::size_t bits = bitset_common::WORD_BITS) {
     word_type tmp =
         bitset_common::ALL_BITS ^ ((bitset_common::ALL_BITS >> (bitset_common::WORD_BITS - bits)) << bit_index());
     word(word_num) = (word(word_num) & tmp) | (value << bit_index());
+    markDirty(&word(word_num));
     std::size_t curr_size = bitset_common::WORD_BITS - bit_index();
     if (bits > curr_size) {
       (*this + curr_size).set_word(value >> curr_size, word_num, bits + bit_index() - bitset_common::WORD_BITS);
     }
   }
 
-  T& word(std::size_t word_num = 0) {
+  constexpr T& word(std::size_t word_num = 0) {
     return word_ptr_[word_num];
   }
 
@@ -173,6 +214,9 @@ private:
 private:
   T* word_ptr_;
   difference_type bit_index_;
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+  bitset_dirty::tracker* dirty_;
+#endif
 };
 
 template <typename T>
@@ -0,0 +1,214 @@
+#include "bitset-matrix.h"
+
+#include "bitset-simd.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+constexpr std::size_t BLOCK_BITS = bitset_common::WORD_BITS;
+// Number of 64x64 blocks transposed together, so that both the source and
+// the destination rows of a tile stay in L1 while it is processed.
+constexpr std::size_t TILE_BLOCKS = 8;
+
+using block = std::array<bitset_common::word_type, BLOCK_BITS>;
+
+std::size_t words_for(std::size_t bits) {
+  return (bits + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS;
+}
+
+// Common size of `rows`, checked before anything is allocated.
+std::size_t common_size(std::span<const bitset> rows) {
+  if (rows.empty()) {
+    return 0;
+  }
+  for (const bitset& row : rows) {
+    if (row.size() != rows.front().size()) {
+      throw std::invalid_argument("bit matrix rows differ in size");
+    }
+  }
+  return rows.front().size();
+}
+} // namespace
+
+bit_matrix::bit_matrix()
+    : rows_(0)
+    , cols_(0)
+    , stride_(0) {}
+
+bit_matrix::bit_matrix(std::size_t rows, std::size_t cols)
+    : rows_(rows)
+    , cols_(cols)
+    , stride_(words_for(cols))
+    , bits_(rows * stride_ * bitset_common::WORD_BITS, false) {}
+
+bit_matrix::bit_matrix(std::size_t rows, std::size_t cols, bool value)
+    : bit_matrix(rows, cols) {
+  if (value) {
+    bits_.set();
+    clear_padding();
+  }
+}
+
+bit_matrix::bit_matrix(std::span<const bitset> rows)
+    : bit_matrix(rows.size(), common_size(rows)) {
+  for (std::size_t i = 0; i < rows_; ++i) {
+    row(i).assign(rows[i]);
+  }
+}
+
+void bit_matrix::swap(bit_matrix& other) noexcept {
+  std::swap(rows_, other.rows_);
+  std::swap(cols_, other.cols_);
+  std::swap(stride_, other.stride_);
+  bits_.swap(other.bits_);
+}
+
+std::size_t bit_matrix::rows() const {
+  return rows_;
+}
+
+std::size_t bit_matrix::cols() const {
+  return cols_;
+}
+
+bool bit_matrix::empty() const {
+  return rows() == 0 || cols() == 0;
+}
+
+bit_matrix::reference bit_matrix::operator()(std::size_t row, std::size_t col) {
+  return bits_[row * stride_ * bitset_common::WORD_BITS + col];
+}
+
+bit_matrix::const_reference bit_matrix::operator()(std::size_t row, std::size_t col) const {
+  return bits_[row * stride_ * bitset_common::WORD_BITS + col];
+}
+
+bit_matrix::view bit_matrix::row(std::size_t index) {
+  return bits_.subview(index * stride_ * bitset_common::WORD_BITS, cols_);
+}
+
+bit_matrix::const_view bit_matrix::row(std::size_t index) const {
+  return bits_.subview(index * stride_ * bitset_common::WORD_BITS, cols_);
+}
+
+bit_matrix bit_matrix::transposed() const {
+  bit_matrix result(cols_, rows_);
+  std::size_t row_blocks = words_for(rows_);
+  block a;
+  for (std::size_t tile_row = 0; tile_row < row_blocks; tile_row += TILE_BLOCKS) {
+    std::size_t tile_row_end = std::min(row_blocks, tile_row + TILE_BLOCKS);
+    for (std::size_t tile_col = 0; tile_col < stride_; tile_col += TILE_BLOCKS) {
+      std::size_t tile_col_end = std::min(stride_, tile_col + TILE_BLOCKS);
+      for (std::size_t block_row = tile_row; block_row < tile_row_end; ++block_row) {
+        std::size_t first_row = block_row * BLOCK_BITS;
+        std::size_t block_rows = std::min(BLOCK_BITS, rows_ - first_row);
+        for (std::size_t block_col = tile_col; block_col < tile_col_end; ++block_col) {
+          for (std::size_t i = 0; i < block_rows; ++i) {
+            a[i] = row_data(first_row + i)[block_col];
+          }
+          std::fill(a.begin() + block_rows, a.end(), bitset_common::ZERO);
+          bitset_simd::transpose_block(a.data());
+          std::size_t first_col = block_col * BLOCK_BITS;
+          std::size_t block_cols = std::min(BLOCK_BITS, cols_ - first_col);
+          for (std::size_t j = 0; j < block_cols; ++j) {
+            result.row_data(first_col + j)[block_row] = a[j];
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<std::size_t> bit_matrix::row_counts() const {
+  std::vector<std::size_t> result(rows_);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    result[i] = row(i).count();
+  }
+  return result;
+}
+
+std::vector<std::size_t> bit_matrix::column_counts() const {
+  std::vector<std::size_t> result(cols_);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    const word_type* data = row_data(i);
+    for (std::size_t n = 0; n < stride_; ++n) {
+      for (word_type word = data[n]; word != 0; word &= word - 1) {
+        ++result[n * bitset_common::WORD_BITS + std::countr_zero(word)];
+      }
+    }
+  }
+  return result;
+}
+
+bitset bit_matrix::or_rows() const {
+  bitset result(cols_, false);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    result |= row(i);
+  }
+  return result;
+}
+
+bitset bit_matrix::and_rows() const {
+  bitset result(cols_, true);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    result &= row(i);
+  }
+  return result;
+}
+
+bitset bit_matrix::or_columns() const {
+  bitset result(rows_, false);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    result[i] = row(i).any();
+  }
+  return result;
+}
+
+bitset bit_matrix::and_columns() const {
+  bitset result(rows_, false);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    result[i] = row(i).all();
+  }
+  return result;
+}
+
+bit_matrix::word_type* bit_matrix::row_data(std::size_t index) {
+  return bits_.data() + index * stride_;
+}
+
+const bit_matrix::word_type* bit_matrix::row_data(std::size_t index) const {
+  return bits_.data() + index * stride_;
+}
+
+void bit_matrix::clear_padding() {
+  std::size_t tail = cols_ % bitset_common::WORD_BITS;
+  if (tail != 0) {
+    for (std::size_t i = 0; i < rows_; ++i) {
+      row_data(i)[stride_ - 1] &= bitset_common::ALL_BITS >> (bitset_common::WORD_BITS - tail);
+    }
+  }
+}
+
+void swap(bit_matrix& lhs, bit_matrix& rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+bool operator==(const bit_matrix& lhs, const bit_matrix& rhs) {
+  if (lhs.rows() != rhs.rows() || lhs.cols() != rhs.cols()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < lhs.rows(); ++i) {
+    if (lhs.row(i) != rhs.row(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool operator!=(const bit_matrix& lhs, const bit_matrix& rhs) {
+  return !(lhs == rhs);
+}
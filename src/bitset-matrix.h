@@ -0,0 +1,67 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Dense rows x cols bit matrix. Every row starts on a word boundary and
+// occupies `stride` words of a single bitset, so rows are plain aligned views.
+class bit_matrix {
+public:
+  using word_type = bitset::word_type;
+  using reference = bitset::reference;
+  using const_reference = bitset::const_reference;
+  using view = bitset::view;
+  using const_view = bitset::const_view;
+
+  bit_matrix();
+  bit_matrix(std::size_t rows, std::size_t cols, bool value);
+  // Throws std::invalid_argument if the rows differ in size.
+  explicit bit_matrix(std::span<const bitset> rows);
+
+  void swap(bit_matrix& other) noexcept;
+
+  std::size_t rows() const;
+  std::size_t cols() const;
+  bool empty() const;
+
+  reference operator()(std::size_t row, std::size_t col);
+  const_reference operator()(std::size_t row, std::size_t col) const;
+
+  view row(std::size_t index);
+  const_view row(std::size_t index) const;
+
+  // Returns the cols x rows matrix, computed with 64x64 word-level block transposes.
+  bit_matrix transposed() const;
+
+  std::vector<std::size_t> row_counts() const;
+  std::vector<std::size_t> column_counts() const;
+
+  // Combine all rows into one bitset of `cols()` bits.
+  bitset or_rows() const;
+  bitset and_rows() const;
+
+  // Combine all columns into one bitset of `rows()` bits.
+  bitset or_columns() const;
+  bitset and_columns() const;
+
+private:
+  bit_matrix(std::size_t rows, std::size_t cols);
+
+  word_type* row_data(std::size_t index);
+  const word_type* row_data(std::size_t index) const;
+  void clear_padding();
+
+private:
+  std::size_t rows_;
+  std::size_t cols_;
+  std::size_t stride_;
+  bitset bits_;
+};
+
+void swap(bit_matrix& lhs, bit_matrix& rhs) noexcept;
+
+bool operator==(const bit_matrix& lhs, const bit_matrix& rhs);
+bool operator!=(const bit_matrix& lhs, const bit_matrix& rhs);
@@ -0,0 +1,149 @@
+#include "bitset-nary.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <vector>
+
+namespace bitset_nary {
+namespace {
+using word_type = bitset::word_type;
+using block = std::array<word_type, BLOCK_WORDS>;
+
+// Number of bits of a `size`-bit view that fall into its word `n`.
+std::size_t word_bits(std::size_t size, std::size_t n) {
+  return std::min(bitset_common::WORD_BITS, size - n * bitset_common::WORD_BITS);
+}
+
+// Calls consume(first_word, words, block) for every block of the inputs, where
+// `block` holds the result of folding the views' words with `op`.
+template <typename Op, typename Consume>
+void fold_blocks(std::span<const bitset::const_view> views, Op op, Consume consume) {
+  std::size_t size = views.front().size();
+  std::size_t total_words = views.front().words_number();
+  block acc;
+  for (std::size_t first = 0; first < total_words; first += BLOCK_WORDS) {
+    std::size_t words = std::min(BLOCK_WORDS, total_words - first);
+    for (std::size_t i = 0; i < views.size(); ++i) {
+      const bitset::const_view& view = views[i];
+      for (std::size_t n = 0; n < words; ++n) {
+        word_type word = view.get_word(first + n, word_bits(size, first + n));
+        acc[n] = (i == 0) ? word : op(acc[n], word);
+      }
+    }
+    consume(first, words, acc);
+  }
+}
+
+template <typename Op>
+bitset fold(std::span<const bitset::const_view> views, Op op) {
+  if (views.empty()) {
+    return bitset();
+  }
+  bitset result(views.front().size(), false);
+  bitset::view out = result;
+  std::size_t size = result.size();
+  fold_blocks(views, op, [&out, size](std::size_t first, std::size_t words, const block& acc) {
+    for (std::size_t n = 0; n < words; ++n) {
+      out.set_word(acc[n], first + n, word_bits(size, first + n));
+    }
+  });
+  return result;
+}
+
+// Calls consume(first_word, words, block) where `block` has a bit set for every
+// position that is set in at least `k` views. Per block, the number of views
+// having each bit set is kept in bit-sliced counters: slice `j` holds bit `j`
+// of all the per-position counts, and an input word is added with a ripple of
+// half adders.
+template <typename Consume>
+void threshold_blocks(std::span<const bitset::const_view> views, std::size_t k, Consume consume) {
+  std::size_t size = views.front().size();
+  std::size_t total_words = views.front().words_number();
+  std::size_t slices = std::bit_width(views.size());
+  std::vector<block> counters(slices);
+  block result;
+  for (std::size_t first = 0; first < total_words; first += BLOCK_WORDS) {
+    std::size_t words = std::min(BLOCK_WORDS, total_words - first);
+    for (block& slice : counters) {
+      std::fill_n(slice.begin(), words, bitset_common::ZERO);
+    }
+    for (const bitset::const_view& view : views) {
+      for (std::size_t n = 0; n < words; ++n) {
+        word_type carry = view.get_word(first + n, word_bits(size, first + n));
+        for (std::size_t j = 0; carry != 0; ++j) {
+          word_type next = counters[j][n] & carry;
+          counters[j][n] ^= carry;
+          carry = next;
+        }
+      }
+    }
+    // counter >= k, compared from the most significant slice down.
+    for (std::size_t n = 0; n < words; ++n) {
+      word_type greater = 0;
+      word_type equal = bitset_common::ALL_BITS;
+      for (std::size_t j = slices; j-- > 0;) {
+        word_type slice = counters[j][n];
+        if ((k >> j) & 1) {
+          equal &= slice;
+        } else {
+          greater |= equal & slice;
+          equal &= ~slice;
+        }
+      }
+      result[n] = (greater | equal) & bitset_common::low_bits(word_bits(size, first + n));
+    }
+    consume(first, words, result);
+  }
+}
+} // namespace
+
+bitset and_all(std::span<const bitset::const_view> views) {
+  return fold(views, [](word_type a, word_type b) { return a & b; });
+}
+
+bitset or_all(std::span<const bitset::const_view> views) {
+  return fold(views, [](word_type a, word_type b) { return a | b; });
+}
+
+bitset xor_all(std::span<const bitset::const_view> views) {
+  return fold(views, [](word_type a, word_type b) { return a ^ b; });
+}
+
+bitset at_least(std::span<const bitset::const_view> views, std::size_t k) {
+  if (views.empty()) {
+    return bitset();
+  }
+  std::size_t size = views.front().size();
+  if (k > views.size()) {
+    return bitset(size, false);
+  }
+  if (k == 0) {
+    return bitset(size, true);
+  }
+  bitset result(size, false);
+  bitset::view out = result;
+  threshold_blocks(views, k, [&out, size](std::size_t first, std::size_t words, const block& acc) {
+    for (std::size_t n = 0; n < words; ++n) {
+      out.set_word(acc[n], first + n, word_bits(size, first + n));
+    }
+  });
+  return result;
+}
+
+std::size_t count_at_least(std::span<const bitset::const_view> views, std::size_t k) {
+  if (views.empty() || k > views.size()) {
+    return 0;
+  }
+  if (k == 0) {
+    return views.front().size();
+  }
+  std::size_t result = 0;
+  threshold_blocks(views, k, [&result](std::size_t, std::size_t words, const block& acc) {
+    for (std::size_t n = 0; n < words; ++n) {
+      result += std::popcount(acc[n]);
+    }
+  });
+  return result;
+}
+} // namespace bitset_nary
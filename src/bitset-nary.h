@@ -0,0 +1,21 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <span>
+
+// Operations over many equally sized views at once. The inputs are walked in
+// blocks of BLOCK_WORDS words, so each output block is built in cache in a
+// single pass instead of materializing a bitset per pairwise operation.
+namespace bitset_nary {
+static constexpr std::size_t BLOCK_WORDS = 512;
+
+bitset and_all(std::span<const bitset::const_view> views);
+bitset or_all(std::span<const bitset::const_view> views);
+bitset xor_all(std::span<const bitset::const_view> views);
+
+// Bits that are set in at least `k` of the views.
+bitset at_least(std::span<const bitset::const_view> views, std::size_t k);
+std::size_t count_at_least(std::span<const bitset::const_view> views, std::size_t k);
+} // namespace bitset_nary
@@ -0,0 +1,427 @@
+#include "bitset-numa.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#ifdef __linux__
+#include <filesystem>
+#include <fstream>
+#include <sched.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bitset_numa {
+namespace {
+#ifdef __linux__
+// From <linux/mempolicy.h>, which is not always installed.
+constexpr int MPOL_PREFERRED_MODE = 1;
+constexpr unsigned MPOL_MF_MOVE_FLAG = 1 << 1;
+
+// Parses a sysfs CPU list such as "0-3,8,10-11".
+std::vector<int> parse_cpu_list(const std::string& list) {
+  std::vector<int> result;
+  std::size_t pos = 0;
+  while (pos < list.size()) {
+    std::size_t end = list.find(',', pos);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    std::string item = list.substr(pos, end - pos);
+    std::size_t dash = item.find('-');
+    try {
+      int first = std::stoi(item.substr(0, dash));
+      int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu) {
+        result.push_back(cpu);
+      }
+    } catch (const std::exception&) {
+      return {};
+    }
+    pos = end + 1;
+  }
+  return result;
+}
+#endif
+} // namespace
+
+std::vector<node> topology() {
+  std::vector<node> result;
+#ifdef __linux__
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+    std::string name = entry.path().filename().string();
+    if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+        !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+      continue;
+    }
+    std::ifstream in(entry.path() / "cpulist");
+    std::string list;
+    std::getline(in, list);
+    std::vector<int> cpus = parse_cpu_list(list);
+    if (!cpus.empty()) {
+      result.push_back({std::stoi(name.substr(4)), std::move(cpus)});
+    }
+  }
+  std::ranges::sort(result, {}, &node::id);
+#endif
+  if (result.empty()) {
+    result.push_back({0, {}});
+  }
+  return result;
+}
+
+namespace {
+// Pins the calling thread to the node's CPUs, if it has any.
+void pin_to(const node& n) {
+#ifdef __linux__
+  if (n.cpus.empty()) {
+    return;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : n.cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  sched_setaffinity(0, sizeof(set), &set);
+#else
+  (void)n;
+#endif
+}
+
+// Asks the kernel to keep the pages of [first, first + words) of a mapped buffer
+// on the node and to move those already touched. `first` is on a huge page
+// boundary and the range is extended to the next one, which the mapping still
+// covers. Best effort: failures leave first-touch placement.
+void bind_to(const node& n, const bitset::word_type* first, std::size_t words) {
+#ifdef __linux__
+  if (words == 0 || n.id < 0) {
+    return;
+  }
+  std::vector<unsigned long> mask(n.id / (8 * sizeof(unsigned long)) + 1, 0);
+  mask[n.id / (8 * sizeof(unsigned long))] |= 1UL << (n.id % (8 * sizeof(unsigned long)));
+  auto begin = reinterpret_cast<uintptr_t>(first);
+  std::size_t bytes = words * sizeof(bitset::word_type);
+  auto end = begin + (bytes + bitset_storage::HUGE_PAGE_SIZE - 1) / bitset_storage::HUGE_PAGE_SIZE *
+                         bitset_storage::HUGE_PAGE_SIZE;
+  syscall(
+      SYS_mbind,
+      begin,
+      end - begin,
+      MPOL_PREFERRED_MODE,
+      mask.data(),
+      // maxnode counts one bit past the last node of the mask.
+      mask.size() * 8 * sizeof(unsigned long) + 1,
+      MPOL_MF_MOVE_FLAG
+  );
+#else
+  (void)n;
+  (void)first;
+  (void)words;
+#endif
+}
+} // namespace
+
+// Workers pinned to one node, one per CPU of its list or a single one if the
+// list is empty. Tasks are taken in submission order by whichever worker is free.
+class worker_pool {
+public:
+  explicit worker_pool(const node& n)
+      : node_(n) {
+    std::size_t workers = std::max<std::size_t>(node_.cpus.size(), 1);
+    workers_.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+      workers_.emplace_back([this](std::stop_token stop) { work(stop); });
+    }
+  }
+
+  std::size_t size() const {
+    return workers_.size();
+  }
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    ready_.notify_one();
+  }
+
+private:
+  void work(std::stop_token stop) {
+    pin_to(node_);
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock(mutex_);
+        if (!ready_.wait(lock, stop, [this] { return !tasks_.empty(); })) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+private:
+  node node_;
+  std::mutex mutex_;
+  std::condition_variable_any ready_;
+  std::deque<std::function<void()>> tasks_;
+  // Last, so that the workers are stopped and joined before the rest goes away.
+  std::vector<std::jthread> workers_;
+};
+
+namespace {
+// Pool of the node, created on first use and kept until exit. Nodes with the
+// same id and CPUs share one pool.
+worker_pool& pool_for(const node& n) {
+  static std::mutex mutex;
+  static std::map<std::pair<int, std::vector<int>>, std::unique_ptr<worker_pool>> pools;
+  std::lock_guard lock(mutex);
+  std::unique_ptr<worker_pool>& pool = pools[{n.id, n.cpus}];
+  if (!pool) {
+    pool = std::make_unique<worker_pool>(n);
+  }
+  return *pool;
+}
+} // namespace
+} // namespace bitset_numa
+
+numa_bitset::numa_bitset(std::size_t size, bool value)
+    : numa_bitset(size, value, bitset_numa::topology()) {}
+
+numa_bitset::numa_bitset(std::size_t size, bool value, std::vector<bitset_numa::node> nodes)
+    : nodes_(std::move(nodes))
+    , bits_(size) {
+  if (nodes_.empty()) {
+    nodes_.push_back({0, {}});
+  }
+  for (const bitset_numa::node& n : nodes_) {
+    pools_.push_back(&bitset_numa::pool_for(n));
+  }
+  bool mapped = bitset_storage::mapped(bits_.capacity());
+  std::size_t segment_bits =
+      (mapped ? bitset_numa::MAPPED_SEGMENT_ALIGN_WORDS : bitset_numa::SEGMENT_ALIGN_WORDS) * bitset_common::WORD_BITS;
+  std::size_t segment_units = (size + segment_bits - 1) / segment_bits;
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    bounds_.push_back(std::min(segment_units * i / nodes_.size() * segment_bits, size));
+  }
+  bounds_.push_back(size);
+
+  constexpr std::size_t PART_BITS = bitset_numa::SEGMENT_ALIGN_WORDS * bitset_common::WORD_BITS;
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    std::size_t units = (bounds_[i + 1] - bounds_[i] + PART_BITS - 1) / PART_BITS;
+    std::size_t workers = pools_[i]->size();
+    for (std::size_t j = 0; j < workers; ++j) {
+      std::size_t first = std::min(bounds_[i] + units * j / workers * PART_BITS, bounds_[i + 1]);
+      std::size_t last = std::min(bounds_[i] + units * (j + 1) / workers * PART_BITS, bounds_[i + 1]);
+      if (first != last) {
+        parts_.push_back({i, first, last});
+      }
+    }
+    if (mapped && nodes_.size() > 1) {
+      bitset_numa::bind_to(
+          nodes_[i],
+          bits_.data() + bounds_[i] / bitset_common::WORD_BITS,
+          (bounds_[i + 1] - bounds_[i] + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS
+      );
+    }
+  }
+  // The storage is not initialized by bits_, so every page is first touched here.
+  for_each_part([this, value](std::size_t p) {
+    word_type* first = bits_.data() + parts_[p].first / bitset_common::WORD_BITS;
+    word_type* last = bits_.data() + (parts_[p].last + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS;
+    std::fill(first, last, value ? bitset_common::ALL_BITS : bitset_common::ZERO);
+  });
+}
+
+std::size_t numa_bitset::size() const {
+  return bits_.size();
+}
+
+bool numa_bitset::empty() const {
+  return size() == 0;
+}
+
+numa_bitset::reference numa_bitset::operator[](std::size_t index) {
+  return bits_[index];
+}
+
+numa_bitset::const_reference numa_bitset::operator[](std::size_t index) const {
+  return bits_[index];
+}
+
+numa_bitset::operator const_view() const {
+  return bits_;
+}
+
+numa_bitset::operator view() {
+  return bits_;
+}
+
+numa_bitset::view numa_bitset::subview(std::size_t offset, std::size_t count) {
+  return bits_.subview(offset, count);
+}
+
+numa_bitset::const_view numa_bitset::subview(std::size_t offset, std::size_t count) const {
+  return bits_.subview(offset, count);
+}
+
+std::size_t numa_bitset::segments() const {
+  return nodes_.size();
+}
+
+const bitset_numa::node& numa_bitset::segment_node(std::size_t index) const {
+  return nodes_[index];
+}
+
+numa_bitset::const_view numa_bitset::segment(std::size_t index) const {
+  return bits_.subview(bounds_[index], bounds_[index + 1] - bounds_[index]);
+}
+
+numa_bitset::view numa_bitset::part_view(std::size_t index) {
+  return bits_.subview(parts_[index].first, parts_[index].last - parts_[index].first);
+}
+
+numa_bitset::const_view numa_bitset::part_view(std::size_t index) const {
+  return bits_.subview(parts_[index].first, parts_[index].last - parts_[index].first);
+}
+
+// Runs func(p) for every part `p` on a worker of its node's pool and waits for
+// all of them. With a single node and a single part the calling thread does it.
+// If func throws, the first exception is rethrown here once every part is done.
+template <typename Func>
+void numa_bitset::for_each_part(Func func) const {
+  if (nodes_.size() == 1 && parts_.size() == 1) {
+    func(0);
+    return;
+  }
+  std::latch done(static_cast<std::ptrdiff_t>(parts_.size()));
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  for (std::size_t p = 0; p < parts_.size(); ++p) {
+    pools_[parts_[p].segment]->submit([&func, &done, &error_mutex, &error, p]() {
+      try {
+        func(p);
+      } catch (...) {
+        std::lock_guard lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+      done.count_down();
+    });
+  }
+  done.wait();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+numa_bitset& numa_bitset::operator&=(const const_view& other) & {
+  for_each_part([this, &other](std::size_t p) {
+    part_view(p) &= other.subview(parts_[p].first, parts_[p].last - parts_[p].first);
+  });
+  return *this;
+}
+
+numa_bitset& numa_bitset::operator|=(const const_view& other) & {
+  for_each_part([this, &other](std::size_t p) {
+    part_view(p) |= other.subview(parts_[p].first, parts_[p].last - parts_[p].first);
+  });
+  return *this;
+}
+
+numa_bitset& numa_bitset::operator^=(const const_view& other) & {
+  for_each_part([this, &other](std::size_t p) {
+    part_view(p) ^= other.subview(parts_[p].first, parts_[p].last - parts_[p].first);
+  });
+  return *this;
+}
+
+numa_bitset& numa_bitset::flip() & {
+  for_each_part([this](std::size_t p) { part_view(p).flip(); });
+  return *this;
+}
+
+numa_bitset& numa_bitset::set() & {
+  for_each_part([this](std::size_t p) { part_view(p).set(); });
+  return *this;
+}
+
+numa_bitset& numa_bitset::reset() & {
+  for_each_part([this](std::size_t p) { part_view(p).reset(); });
+  return *this;
+}
+
+std::size_t numa_bitset::count() const {
+  std::atomic<std::size_t> result = 0;
+  for_each_part([this, &result](std::size_t p) { result += part_view(p).count(); });
+  return result;
+}
+
+bool numa_bitset::any() const {
+  std::atomic<bool> result = false;
+  for_each_part([this, &result](std::size_t p) {
+    if (part_view(p).any()) {
+      result = true;
+    }
+  });
+  return result;
+}
+
+bool numa_bitset::equals(const const_view& other) const {
+  if (other.size() != size()) {
+    return false;
+  }
+  std::atomic<bool> result = true;
+  for_each_part([this, &other, &result](std::size_t p) {
+    if (part_view(p) != other.subview(parts_[p].first, parts_[p].last - parts_[p].first)) {
+      result = false;
+    }
+  });
+  return result;
+}
+
+std::vector<uint64_t> numa_bitset::ones() const {
+  std::vector<std::vector<uint64_t>> found(parts_.size());
+  for_each_part([this, &found](std::size_t p) {
+    const_view part = part_view(p);
+    for (std::size_t n = 0; n < part.words_number(); ++n) {
+      std::size_t bits = std::min(bitset_common::WORD_BITS, part.size() - n * bitset_common::WORD_BITS);
+      for (word_type word = part.get_word(n, bits); word != 0; word &= word - 1) {
+        found[p].push_back(parts_[p].first + n * bitset_common::WORD_BITS + std::countr_zero(word));
+      }
+    }
+  });
+  std::vector<uint64_t> result;
+  for (const std::vector<uint64_t>& part : found) {
+    result.insert(result.end(), part.begin(), part.end());
+  }
+  return result;
+}
+
+bool operator==(const numa_bitset& lhs, const numa_bitset& rhs) {
+  return lhs.equals(rhs);
+}
+
+bool operator!=(const numa_bitset& lhs, const numa_bitset& rhs) {
+  return !(lhs == rhs);
+}
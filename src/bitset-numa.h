@@ -0,0 +1,110 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bitset_numa {
+struct node {
+  int id;
+  // CPUs of the node; threads working on its memory are pinned to them.
+  std::vector<int> cpus;
+};
+
+// Nodes with CPUs, read from /sys/devices/system/node. Elsewhere, or if sysfs
+// has no node information, a single node without CPU list.
+std::vector<node> topology();
+
+// Segment boundaries are multiples of 256 KiB: whole pages, and never inside
+// one word of a dirty-tracking summary, so segments can be written concurrently.
+// The parts a segment is split into for its node's workers are aligned the same.
+static constexpr std::size_t SEGMENT_ALIGN_WORDS = bitset_dirty::BLOCK_WORDS * bitset_common::WORD_BITS;
+// Segment boundaries of mapped storage (see bitset_storage::mapped), which may be
+// backed by huge pages: no page of a segment is shared with another node.
+static constexpr std::size_t MAPPED_SEGMENT_ALIGN_WORDS =
+    bitset_storage::HUGE_PAGE_SIZE / sizeof(bitset_common::word_type);
+
+class worker_pool;
+} // namespace bitset_numa
+
+// Bitset whose words are split into one contiguous segment per NUMA node. Each
+// segment is first touched by threads pinned to its node and, when the storage
+// is mapped, bound to the node with mbind. Heap storage shares pages with other
+// objects, so it is left to first-touch placement. Bulk operations split every
+// segment among a pool of workers pinned to its node, one per CPU of the node,
+// started once per process and shared by all numa_bitsets; sequential users see
+// the words as a single ordinary view.
+class numa_bitset {
+public:
+  using word_type = bitset::word_type;
+  using reference = bitset::reference;
+  using const_reference = bitset::const_reference;
+  using view = bitset::view;
+  using const_view = bitset::const_view;
+
+  static constexpr std::size_t npos = -1;
+
+  numa_bitset(std::size_t size, bool value);
+  numa_bitset(std::size_t size, bool value, std::vector<bitset_numa::node> nodes);
+  // A copy would be placed wherever the copying thread runs; copy the bits into
+  // a new numa_bitset instead.
+  numa_bitset(const numa_bitset&) = delete;
+  numa_bitset(numa_bitset&&) noexcept = default;
+  numa_bitset& operator=(const numa_bitset&) = delete;
+  numa_bitset& operator=(numa_bitset&&) noexcept = default;
+
+  std::size_t size() const;
+  bool empty() const;
+
+  reference operator[](std::size_t index);
+  const_reference operator[](std::size_t index) const;
+
+  operator const_view() const;
+  operator view();
+  view subview(std::size_t offset = 0, std::size_t count = npos);
+  const_view subview(std::size_t offset = 0, std::size_t count = npos) const;
+
+  std::size_t segments() const;
+  const bitset_numa::node& segment_node(std::size_t index) const;
+  const_view segment(std::size_t index) const;
+
+  // `other` must have size() bits.
+  numa_bitset& operator&=(const const_view& other) &;
+  numa_bitset& operator|=(const const_view& other) &;
+  numa_bitset& operator^=(const const_view& other) &;
+  numa_bitset& flip() &;
+  numa_bitset& set() &;
+  numa_bitset& reset() &;
+
+  std::size_t count() const;
+  bool any() const;
+  bool equals(const const_view& other) const;
+  // Indices of the set bits, in increasing order.
+  std::vector<uint64_t> ones() const;
+
+private:
+  // Bits [first, last) of segment `segment`, run as one task of its node's pool.
+  struct part {
+    std::size_t segment;
+    std::size_t first;
+    std::size_t last;
+  };
+
+  view part_view(std::size_t index);
+  const_view part_view(std::size_t index) const;
+
+  template <typename Func>
+  void for_each_part(Func func) const;
+
+private:
+  std::vector<bitset_numa::node> nodes_;
+  std::vector<bitset_numa::worker_pool*> pools_;
+  std::vector<std::size_t> bounds_;
+  std::vector<part> parts_;
+  bitset bits_;
+};
+
+bool operator==(const numa_bitset& lhs, const numa_bitset& rhs);
+bool operator!=(const numa_bitset& lhs, const numa_bitset& rhs);
@@ -0,0 +1,90 @@
+#include "bitset-random.h"
+
+namespace bitset_random {
+namespace {
+using word_type = bitset::word_type;
+
+std::size_t word_bits(std::size_t size, std::size_t n) {
+  return std::min(bitset_common::WORD_BITS, size - n * bitset_common::WORD_BITS);
+}
+
+// Position of the set bit of `word` with the given rank, which must be below
+// popcount(word): whole bytes are skipped by their popcounts first.
+std::size_t select_in_word(word_type word, std::size_t rank) {
+  std::size_t offset = 0;
+  for (std::size_t ones = std::popcount(word & 0xFF); ones <= rank; ones = std::popcount(word & 0xFF)) {
+    rank -= ones;
+    word >>= 8;
+    offset += 8;
+  }
+  for (; rank > 0; --rank) {
+    word &= word - 1;
+  }
+  return offset + std::countr_zero(word);
+}
+
+std::size_t blocks_for(std::size_t words) {
+  return (words + SAMPLER_BLOCK_WORDS - 1) / SAMPLER_BLOCK_WORDS;
+}
+} // namespace
+
+std::size_t select(const bitset::const_view& bits, std::size_t rank) {
+  for (std::size_t n = 0; n < bits.words_number(); ++n) {
+    word_type word = bits.get_word(n, word_bits(bits.size(), n));
+    std::size_t ones = std::popcount(word);
+    if (rank < ones) {
+      return n * bitset_common::WORD_BITS + select_in_word(word, rank);
+    }
+    rank -= ones;
+  }
+  return npos;
+}
+
+void select(const bitset::const_view& bits, std::span<const std::size_t> ranks, std::span<std::size_t> out) {
+  std::size_t i = 0;
+  std::size_t preceding = 0;
+  for (std::size_t n = 0; n < bits.words_number() && i < ranks.size(); ++n) {
+    word_type word = bits.get_word(n, word_bits(bits.size(), n));
+    std::size_t ones = std::popcount(word);
+    for (; i < ranks.size() && ranks[i] < preceding + ones; ++i) {
+      out[i] = n * bitset_common::WORD_BITS + select_in_word(word, ranks[i] - preceding);
+    }
+    preceding += ones;
+  }
+}
+
+set_bit_sampler::set_bit_sampler(const bitset::const_view& bits)
+    : bits_(bits) {
+  std::size_t words = bits_.words_number();
+  prefix_.reserve(blocks_for(words) + 1);
+  prefix_.push_back(0);
+  std::size_t ones = 0;
+  for (std::size_t n = 0; n < words; ++n) {
+    ones += std::popcount(bits_.get_word(n, word_bits(bits_.size(), n)));
+    if ((n + 1) % SAMPLER_BLOCK_WORDS == 0 || n + 1 == words) {
+      prefix_.push_back(ones);
+    }
+  }
+}
+
+std::size_t set_bit_sampler::count() const {
+  return prefix_.back();
+}
+
+std::size_t set_bit_sampler::select(std::size_t rank) const {
+  if (rank >= count()) {
+    return npos;
+  }
+  // The last block whose preceding count is at most `rank` holds the bit.
+  std::size_t block = std::ranges::upper_bound(prefix_, rank) - prefix_.begin() - 1;
+  rank -= prefix_[block];
+  for (std::size_t n = block * SAMPLER_BLOCK_WORDS;; ++n) {
+    word_type word = bits_.get_word(n, word_bits(bits_.size(), n));
+    std::size_t ones = std::popcount(word);
+    if (rank < ones) {
+      return n * bitset_common::WORD_BITS + select_in_word(word, rank);
+    }
+    rank -= ones;
+  }
+}
+} // namespace bitset_random
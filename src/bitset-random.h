@@ -0,0 +1,189 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+// Random bitsets and random picks among set bits. Fills build whole words out
+// of a few generator draws instead of drawing once per bit; picks from a view
+// locate a chosen rank with one popcount per word and stop at the word that
+// holds it, and a set_bit_sampler serves repeated picks from the same view.
+namespace bitset_random {
+static constexpr std::size_t npos = -1;
+
+// Densities below this, or above one minus it, are filled by geometric skipping
+// between the rare bits instead of word by word.
+static constexpr double SPARSE_DENSITY = 1.0 / 32;
+
+// Random positions probed by sample_set_bit before falling back to counting.
+static constexpr std::size_t SAMPLE_PROBES = 8;
+
+// Words per block of a set_bit_sampler: one cache line.
+static constexpr std::size_t SAMPLER_BLOCK_WORDS = 8;
+
+// Position of the set bit with the given 0-based rank, or npos if the view has
+// at most `rank` set bits.
+std::size_t select(const bitset::const_view& bits, std::size_t rank);
+
+// out[i] is the position of the set bit with rank ranks[i], all found in one
+// pass. The ranks must be sorted and below bits.count().
+void select(const bitset::const_view& bits, std::span<const std::size_t> ranks, std::span<std::size_t> out);
+
+// Rank index over the set bits of a view, built in one pass: the number of set
+// bits before every block of SAMPLER_BLOCK_WORDS words. A select is a binary
+// search over the blocks and a scan of one block, so repeated draws from the
+// same view cost O(log blocks) each. The view must outlive the sampler and not
+// change while it is used.
+class set_bit_sampler {
+public:
+  explicit set_bit_sampler(const bitset::const_view& bits);
+
+  // Number of set bits of the view.
+  std::size_t count() const;
+  // Position of the set bit with the given 0-based rank, or npos if rank >= count().
+  std::size_t select(std::size_t rank) const;
+
+private:
+  bitset::const_view bits_;
+  // prefix_[b] is the number of set bits in the blocks before block b; the last
+  // entry is count().
+  std::vector<std::size_t> prefix_;
+};
+
+// `k` distinct ranks below `count` chosen uniformly with Floyd's algorithm, in
+// O(k) draws, sorted; every rank if k >= count.
+template <typename URBG>
+std::vector<std::size_t> random_ranks(std::size_t count, std::size_t k, URBG& rng) {
+  k = std::min(k, count);
+  std::vector<std::size_t> ranks;
+  ranks.reserve(k);
+  if (k == count) {
+    for (std::size_t rank = 0; rank < count; ++rank) {
+      ranks.push_back(rank);
+    }
+    return ranks;
+  }
+  std::unordered_set<std::size_t> chosen;
+  for (std::size_t j = count - k; j < count; ++j) {
+    std::size_t rank = std::uniform_int_distribution<std::size_t>(0, j)(rng);
+    if (!chosen.insert(rank).second) {
+      rank = j;
+      chosen.insert(rank);
+    }
+    ranks.push_back(rank);
+  }
+  std::ranges::sort(ranks);
+  return ranks;
+}
+
+template <typename URBG>
+bitset::word_type random_word(URBG& rng) {
+  return std::uniform_int_distribution<bitset::word_type>()(rng);
+}
+
+// Sets every bit independently with probability `p`, exactly to the precision
+// of the double. Between SPARSE_DENSITY and 1 - SPARSE_DENSITY each bit compares
+// a uniform number, drawn one binary digit per word rj, with p = 0.d1 d2 ...:
+// at the first digit where rj differs from dj the bit is 1 if dj is, and bits
+// still undecided when p runs out of digits are 0. A word is done once none is
+// undecided, about 7 draws on average, and 0.5 costs one draw per word.
+template <typename URBG>
+void fill_random(const bitset::view& target, double p, URBG& rng) {
+  if (p <= 0) {
+    target.reset();
+    return;
+  }
+  if (p >= 1) {
+    target.set();
+    return;
+  }
+  if (p < SPARSE_DENSITY || p > 1 - SPARSE_DENSITY) {
+    // The rare value is placed on a background of the other one.
+    bool rare = p < SPARSE_DENSITY;
+    if (rare) {
+      target.reset();
+    } else {
+      target.set();
+    }
+    std::geometric_distribution<std::size_t> gap(rare ? p : 1 - p);
+    for (std::size_t i = gap(rng); i < target.size(); i += gap(rng) + 1) {
+      target[i] = rare;
+    }
+    return;
+  }
+  for (std::size_t n = 0; n < target.words_number(); ++n) {
+    bitset::word_type word = 0;
+    bitset::word_type undecided = bitset_common::ALL_BITS;
+    // Doubling and dropping the integer part are exact, so the digits of p end
+    // after at most 58 rounds for p >= SPARSE_DENSITY.
+    for (double rest = p; undecided != 0 && rest > 0;) {
+      rest *= 2;
+      bitset::word_type r = random_word(rng);
+      if (rest >= 1) {
+        rest -= 1;
+        word |= undecided & ~r;
+        undecided &= r;
+      } else {
+        undecided &= ~r;
+      }
+    }
+    target.set_word(word, n, std::min(bitset_common::WORD_BITS, target.size() - n * bitset_common::WORD_BITS));
+  }
+}
+
+// A uniformly chosen set bit, or npos if there is none. Dense views are served
+// by probing random positions; if every probe misses, a set bit is chosen by
+// rank. For repeated draws from a sparse view, build a set_bit_sampler.
+template <typename URBG>
+std::size_t sample_set_bit(const bitset::const_view& bits, URBG& rng) {
+  if (bits.empty()) {
+    return npos;
+  }
+  std::uniform_int_distribution<std::size_t> position(0, bits.size() - 1);
+  for (std::size_t probe = 0; probe < SAMPLE_PROBES; ++probe) {
+    std::size_t i = position(rng);
+    if (bits[i]) {
+      return i;
+    }
+  }
+  std::size_t count = bits.count();
+  if (count == 0) {
+    return npos;
+  }
+  return select(bits, std::uniform_int_distribution<std::size_t>(0, count - 1)(rng));
+}
+
+// `k` distinct set bits chosen uniformly, in increasing order; every set bit if
+// there are at most `k`. The ranks are found in one pass over the view.
+template <typename URBG>
+std::vector<std::size_t> sample_k(const bitset::const_view& bits, std::size_t k, URBG& rng) {
+  std::vector<std::size_t> ranks = random_ranks(bits.count(), k, rng);
+  std::vector<std::size_t> result(ranks.size());
+  select(bits, ranks, result);
+  return result;
+}
+
+// A uniformly chosen set bit of the sampler's view, or npos if there is none.
+template <typename URBG>
+std::size_t sample_set_bit(const set_bit_sampler& sampler, URBG& rng) {
+  if (sampler.count() == 0) {
+    return npos;
+  }
+  return sampler.select(std::uniform_int_distribution<std::size_t>(0, sampler.count() - 1)(rng));
+}
+
+// As sample_k on the sampler's view, with one O(log blocks) select per pick.
+template <typename URBG>
+std::vector<std::size_t> sample_k(const set_bit_sampler& sampler, std::size_t k, URBG& rng) {
+  std::vector<std::size_t> result = random_ranks(sampler.count(), k, rng);
+  for (std::size_t& pick : result) {
+    pick = sampler.select(pick);
+  }
+  return result;
+}
+} // namespace bitset_random
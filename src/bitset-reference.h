@@ -1,9 +1,11 @@
 #pragma once
 
 #include "bitset-common.h"
+#include "bitset-dirty.h"
 
 #include <cstddef>
 #include <iostream>
+#include <type_traits>
 #include <utility>
 
 class bitset;
@@ -14,54 +16,79 @@ class bitset_iterator;
 template <typename T>
 class bitset_reference {
 public:
-  bitset_reference operator=(bool b) const {
+  constexpr bitset_reference operator=(bool b) const {
     *word_ = (*word_ & (bitset_common::ALL_BITS ^ (bitset_common::ONE << bit_index_))) | (T(b) << bit_index_);
-    return {word_, bit_index_};
+    markDirty();
+    return *this;
   }
 
   template <bitset_common::NonConst U = T>
-  bitset_reference operator&=(bool b) const {
+  constexpr bitset_reference operator&=(bool b) const {
     return operator=(bool(*this) && b);
   }
 
   template <bitset_common::NonConst U = T>
-  bitset_reference operator|=(bool b) const {
+  constexpr bitset_reference operator|=(bool b) const {
     return operator=(bool(*this) || b);
   }
 
   template <bitset_common::NonConst U = T>
-  bitset_reference operator^=(bool b) const {
+  constexpr bitset_reference operator^=(bool b) const {
     return operator=(bool(*this) ^ b);
     ;
   }
 
-  operator bitset_reference<const T>() const {
+  constexpr operator bitset_reference<const T>() const {
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+    return {word_, bit_index_, dirty_};
+#else
     return {word_, bit_index_};
+#endif
   }
 
-  bitset_reference operator[](std::ptrdiff_t index) const {
+  constexpr bitset_reference operator[](std::ptrdiff_t index) const {
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+    return bitset_reference(word_, bit_index_ + index, dirty_);
+#else
     return bitset_reference(word_, bit_index_ + index);
+#endif
   }
 
   template <bitset_common::NonConst U = T>
-  void flip() const {
+  constexpr void flip() const {
     *word_ ^= T(1) << bit_index_;
+    markDirty();
   }
 
-  operator bool() const {
+  constexpr operator bool() const {
     return (*word_ >> bit_index_) & 1;
   }
 
-  void swap(bitset_reference& other) noexcept {
+  constexpr void swap(bitset_reference& other) noexcept {
     std::swap(word_, other.word_);
     std::swap(word_, other.word_);
   }
 
 private:
-  bitset_reference(T* data_, std::size_t bit_index)
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+  constexpr bitset_reference(T* data_, std::size_t bit_index, bitset_dirty::tracker* dirty)
+      : word_(data_ + bit_index / bitset_common::WORD_BITS)
+      , bit_index_(bit_index % bitset_common::WORD_BITS)
+      , dirty_(dirty) {}
+
+  constexpr void markDirty() const {
+    if (!std::is_constant_evaluated()) {
+      dirty_->mark(word_);
+    }
+  }
+#else
+  constexpr bitset_reference(T* data_, std::size_t bit_index)
       : word_(data_ + bit_index / bitset_common::WORD_BITS)
       , bit_index_(bit_index % bitset_common::WORD_BITS) {}
 
+  constexpr void markDirty() const {}
+#endif
+
   friend bitset;
 
   template <typename K>
@@ -73,4 +100,7 @@ private:
 private:
   T* word_;
   std::size_t bit_index_;
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+  bitset_dirty::tracker* dirty_;
+#endif
 };
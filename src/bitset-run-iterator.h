@@ -0,0 +1,112 @@
+#pragma once
+
+#include "bitset-common.h"
+#include "bitset-iterator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+
+// Maximal run of equal bits: bits [start, start + length) of a view.
+struct bitset_run {
+  std::size_t start;
+  std::size_t length;
+
+  friend bool operator==(const bitset_run&, const bitset_run&) = default;
+};
+
+// Forward iterator over the maximal runs of `value` bits in a range, in order.
+// Each step costs one countr_zero to find the start of the next run and one
+// countr_one to find its end; words made entirely of the other value, or of
+// the searched one in the middle of a run, are passed with a single compare.
+template <typename T>
+class bitset_run_iterator {
+public:
+  using value_type = bitset_run;
+  using difference_type = std::ptrdiff_t;
+  using reference = const bitset_run&;
+  using pointer = const bitset_run*;
+  using iterator_category = std::forward_iterator_tag;
+
+  constexpr bitset_run_iterator() = default;
+
+  constexpr bitset_run_iterator(bitset_iterator<const T> first, std::size_t size, bool value)
+      : first_(first)
+      , size_(size)
+      , invert_(value ? bitset_common::ZERO : bitset_common::ALL_BITS) {
+    findRun(0);
+  }
+
+  constexpr reference operator*() const {
+    return run_;
+  }
+
+  constexpr pointer operator->() const {
+    return &run_;
+  }
+
+  constexpr bitset_run_iterator& operator++() {
+    findRun(run_.start + run_.length);
+    return *this;
+  }
+
+  constexpr bitset_run_iterator operator++(int) {
+    bitset_run_iterator copy = *this;
+    ++*this;
+    return copy;
+  }
+
+  friend constexpr bool operator==(const bitset_run_iterator& lhs, const bitset_run_iterator& rhs) {
+    return lhs.run_.start == rhs.run_.start;
+  }
+
+  friend constexpr bool operator==(const bitset_run_iterator& it, std::default_sentinel_t) {
+    return it.run_.start == it.size_;
+  }
+
+private:
+  // Word `n` of the range with the searched value as ones and the bits past
+  // the end of the range cleared.
+  constexpr bitset_common::word_type load(std::size_t n) {
+    std::size_t bits = std::min(bitset_common::WORD_BITS, size_ - n * bitset_common::WORD_BITS);
+    return (first_.get_word(n, bits) ^ invert_) & bitset_common::low_bits(bits);
+  }
+
+  constexpr void findRun(std::size_t from) {
+    run_ = {size_, 0};
+    if (from >= size_) {
+      return;
+    }
+    std::size_t words = (size_ + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS;
+    std::size_t n = from / bitset_common::WORD_BITS;
+    bitset_common::word_type word = load(n) & (bitset_common::ALL_BITS << (from % bitset_common::WORD_BITS));
+    while (word == 0) {
+      if (++n == words) {
+        return;
+      }
+      word = load(n);
+    }
+    std::size_t offset = std::countr_zero(word);
+    std::size_t start = n * bitset_common::WORD_BITS + offset;
+    std::size_t end = start + std::countr_one(word >> offset);
+    if (end == (n + 1) * bitset_common::WORD_BITS) {
+      // The run reaches the end of the word. A partial last word is never all
+      // ones after load, so running off the last word means the range ends.
+      for (++n; n < words; ++n) {
+        word = load(n);
+        if (word != bitset_common::ALL_BITS) {
+          break;
+        }
+      }
+      end = n < words ? n * bitset_common::WORD_BITS + std::countr_one(word) : size_;
+    }
+    run_ = {start, end - start};
+  }
+
+private:
+  bitset_iterator<const T> first_;
+  std::size_t size_ = 0;
+  bitset_common::word_type invert_ = 0;
+  bitset_run run_ = {0, 0};
+};
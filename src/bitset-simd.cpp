@@ -0,0 +1,127 @@
+#include "bitset-simd.h"
+
+#include <bit>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace bitset_simd {
+namespace {
+constexpr std::size_t BLOCK_BITS = bitset_common::WORD_BITS;
+
+// Bits exchanged by the transpose round with sub-blocks of size j, for j = 32, 16, ..., 1.
+constexpr word_type TRANSPOSE_MASKS[] = {
+    0x00000000FFFFFFFF,
+    0x0000FFFF0000FFFF,
+    0x00FF00FF00FF00FF,
+    0x0F0F0F0F0F0F0F0F,
+    0x3333333333333333,
+    0x5555555555555555,
+};
+} // namespace
+
+void transpose_block_scalar(word_type* block) {
+  std::size_t round = 0;
+  for (std::size_t j = BLOCK_BITS / 2; j != 0; j >>= 1, ++round) {
+    word_type mask = TRANSPOSE_MASKS[round];
+    for (std::size_t k = 0; k < BLOCK_BITS; k = ((k | j) + 1) & ~j) {
+      word_type t = ((block[k] >> j) ^ block[k | j]) & mask;
+      block[k] ^= t << j;
+      block[k | j] ^= t;
+    }
+  }
+}
+
+bool covers_scalar(const word_type* words, const word_type* mask, std::size_t count) {
+  word_type missing = 0;
+  for (std::size_t n = 0; n < count; ++n) {
+    missing |= mask[n] & ~words[n];
+  }
+  return missing == 0;
+}
+
+std::size_t xor_count_scalar(const word_type* lhs, const word_type* rhs, std::size_t count) {
+  std::size_t result = 0;
+  for (std::size_t n = 0; n < count; ++n) {
+    result += std::popcount(lhs[n] ^ rhs[n]);
+  }
+  return result;
+}
+
+#ifdef __AVX2__
+void transpose_block_avx2(word_type* block) {
+  auto load = [block](std::size_t k) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + k)); };
+  auto store = [block](std::size_t k, __m256i value) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(block + k), value);
+  };
+  std::size_t round = 0;
+  for (std::size_t j = BLOCK_BITS / 2; j >= 4; j >>= 1, ++round) {
+    __m256i mask = _mm256_set1_epi64x(static_cast<long long>(TRANSPOSE_MASKS[round]));
+    __m128i shift = _mm_cvtsi64_si128(static_cast<long long>(j));
+    for (std::size_t base = 0; base < BLOCK_BITS; base += 2 * j) {
+      for (std::size_t k = base; k < base + j; k += 4) {
+        __m256i x = load(k);
+        __m256i y = load(k + j);
+        __m256i t = _mm256_and_si256(_mm256_xor_si256(_mm256_srl_epi64(x, shift), y), mask);
+        store(k, _mm256_xor_si256(x, _mm256_sll_epi64(t, shift)));
+        store(k + j, _mm256_xor_si256(y, t));
+      }
+    }
+  }
+  // j = 2 pairs lanes (0, 2) and (1, 3), j = 1 pairs lanes (0, 1) and (2, 3).
+  // `lower` holds the lower row of each pair in both of its lanes and `upper`
+  // the other one, so one shift-xor-and computes t for both lanes of a pair.
+  __m256i mask2 = _mm256_set1_epi64x(static_cast<long long>(TRANSPOSE_MASKS[4]));
+  __m256i mask1 = _mm256_set1_epi64x(static_cast<long long>(TRANSPOSE_MASKS[5]));
+  for (std::size_t k = 0; k < BLOCK_BITS; k += 4) {
+    __m256i x = load(k);
+    __m256i partner = _mm256_permute4x64_epi64(x, 0x4E);
+    __m256i lower = _mm256_blend_epi32(x, partner, 0xF0);
+    __m256i upper = _mm256_blend_epi32(partner, x, 0xF0);
+    __m256i t = _mm256_and_si256(_mm256_xor_si256(_mm256_srli_epi64(lower, 2), upper), mask2);
+    x = _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_slli_epi64(t, 2), t, 0xF0));
+
+    partner = _mm256_shuffle_epi32(x, 0x4E);
+    lower = _mm256_blend_epi32(x, partner, 0xCC);
+    upper = _mm256_blend_epi32(partner, x, 0xCC);
+    t = _mm256_and_si256(_mm256_xor_si256(_mm256_srli_epi64(lower, 1), upper), mask1);
+    store(k, _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_slli_epi64(t, 1), t, 0xCC)));
+  }
+}
+
+bool covers_avx2(const word_type* words, const word_type* mask, std::size_t count) {
+  __m256i missing = _mm256_setzero_si256();
+  std::size_t n = 0;
+  for (; n + 4 <= count; n += 4) {
+    __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + n));
+    __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + n));
+    missing = _mm256_or_si256(missing, _mm256_andnot_si256(w, m));
+  }
+  return _mm256_testz_si256(missing, missing) != 0 && covers_scalar(words + n, mask + n, count - n);
+}
+
+std::size_t xor_count_avx2(const word_type* lhs, const word_type* rhs, std::size_t count) {
+  const __m256i nibble_counts = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+  );
+  const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+  __m256i total = _mm256_setzero_si256();
+  std::size_t n = 0;
+  for (; n + 4 <= count; n += 4) {
+    __m256i x = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + n)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + n))
+    );
+    __m256i low = _mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(x, low_nibbles));
+    __m256i high = _mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_nibbles));
+    total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+  }
+  std::size_t result = static_cast<std::size_t>(_mm256_extract_epi64(total, 0)) +
+                       static_cast<std::size_t>(_mm256_extract_epi64(total, 1)) +
+                       static_cast<std::size_t>(_mm256_extract_epi64(total, 2)) +
+                       static_cast<std::size_t>(_mm256_extract_epi64(total, 3));
+  return result + xor_count_scalar(lhs + n, rhs + n, count - n);
+}
+#endif
+} // namespace bitset_simd
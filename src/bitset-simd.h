@@ -0,0 +1,63 @@
+#pragma once
+
+#include "bitset-common.h"
+
+#include <cstddef>
+
+// Word kernels with a hand-written AVX2 version, used when the build targets
+// AVX2 (see the BITSET_ENABLE_AVX2 CMake option), and a portable one used
+// otherwise. The portable kernels are always compiled so that both versions
+// can be checked against each other.
+namespace bitset_simd {
+using word_type = bitset_common::word_type;
+
+// In-place transpose of a 64x64 bit block where bit `j` of word `i` is element
+// (i, j), by the recursive swap network: six rounds exchanging j x j sub-blocks
+// for j = 32, 16, ..., 1.
+void transpose_block_scalar(word_type* block);
+#ifdef __AVX2__
+// Rounds with j >= 4 exchange four rows per instruction; the last two rounds
+// pair lanes inside one register with a permute and a blend.
+void transpose_block_avx2(word_type* block);
+#endif
+
+inline void transpose_block(word_type* block) {
+#ifdef __AVX2__
+  transpose_block_avx2(block);
+#else
+  transpose_block_scalar(block);
+#endif
+}
+// Whether every bit set in `mask` is also set in `words`, both `count` words
+// long. The AVX2 version accumulates mask & ~words four words at a time and
+// tests the accumulator once.
+bool covers_scalar(const word_type* words, const word_type* mask, std::size_t count);
+#ifdef __AVX2__
+bool covers_avx2(const word_type* words, const word_type* mask, std::size_t count);
+#endif
+
+inline bool covers(const word_type* words, const word_type* mask, std::size_t count) {
+#ifdef __AVX2__
+  return covers_avx2(words, mask, count);
+#else
+  return covers_scalar(words, mask, count);
+#endif
+}
+
+// Number of bits that differ between `lhs` and `rhs`, both `count` words long.
+// The AVX2 version counts the bits of four XORed words at once by looking up
+// each nibble in a 16-entry table with a byte shuffle, and sums the byte counts
+// into 64-bit lanes with a sum of absolute differences.
+std::size_t xor_count_scalar(const word_type* lhs, const word_type* rhs, std::size_t count);
+#ifdef __AVX2__
+std::size_t xor_count_avx2(const word_type* lhs, const word_type* rhs, std::size_t count);
+#endif
+
+inline std::size_t xor_count(const word_type* lhs, const word_type* rhs, std::size_t count) {
+#ifdef __AVX2__
+  return xor_count_avx2(lhs, rhs, count);
+#else
+  return xor_count_scalar(lhs, rhs, count);
+#endif
+}
+} // namespace bitset_simd
@@ -0,0 +1,137 @@
+#include "bitset-sliced-index.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace {
+using word_type = bitset::word_type;
+
+std::size_t word_bits(std::size_t size, std::size_t n) {
+  return std::min(bitset_common::WORD_BITS, size - n * bitset_common::WORD_BITS);
+}
+} // namespace
+
+bit_sliced_index::bit_sliced_index()
+    : size_(0) {}
+
+bit_sliced_index::bit_sliced_index(std::span<const uint64_t> values)
+    : size_(values.size()) {
+  std::size_t slices = std::bit_width(values.empty() ? uint64_t(0) : *std::ranges::max_element(values));
+  slices_.assign(slices, bitset(size_, false));
+  std::array<word_type, bitset_common::WORD_BITS> words{};
+  for (std::size_t first = 0; first < size_; first += bitset_common::WORD_BITS) {
+    std::size_t n = first / bitset_common::WORD_BITS;
+    std::size_t bits = word_bits(size_, n);
+    std::fill_n(words.begin(), slices, bitset_common::ZERO);
+    for (std::size_t i = 0; i < bits; ++i) {
+      for (uint64_t x = values[first + i]; x != 0; x &= x - 1) {
+        words[std::countr_zero(x)] |= bitset_common::ONE << i;
+      }
+    }
+    for (std::size_t j = 0; j < slices; ++j) {
+      slices_[j].subview().set_word(words[j], n, bits);
+    }
+  }
+}
+
+std::size_t bit_sliced_index::size() const {
+  return size_;
+}
+
+bool bit_sliced_index::empty() const {
+  return size() == 0;
+}
+
+std::size_t bit_sliced_index::slices() const {
+  return slices_.size();
+}
+
+bitset::const_view bit_sliced_index::slice(std::size_t bit) const {
+  return slices_[bit];
+}
+
+uint64_t bit_sliced_index::value(std::size_t row) const {
+  uint64_t result = 0;
+  for (std::size_t j = 0; j < slices(); ++j) {
+    result |= uint64_t(slices_[j][row]) << j;
+  }
+  return result;
+}
+
+bit_sliced_index::comparison bit_sliced_index::compare_word(std::size_t n, uint64_t value) const {
+  if (std::bit_width(value) > slices()) {
+    return {bitset_common::ALL_BITS, bitset_common::ZERO};
+  }
+  comparison result = {bitset_common::ZERO, bitset_common::ALL_BITS};
+  for (std::size_t j = slices(); j-- > 0;) {
+    word_type slice = slices_[j].subview().get_word(n);
+    if ((value >> j) & 1) {
+      result.less |= result.equal & ~slice;
+      result.equal &= slice;
+    } else {
+      result.equal &= ~slice;
+    }
+  }
+  return result;
+}
+
+template <typename Predicate>
+bitset bit_sliced_index::evaluate(Predicate predicate) const {
+  bitset result(size_, false);
+  bitset::view out = result;
+  for (std::size_t n = 0; n < out.words_number(); ++n) {
+    out.set_word(predicate(n), n, word_bits(size_, n));
+  }
+  return result;
+}
+
+bitset bit_sliced_index::equal(uint64_t value) const {
+  return evaluate([this, value](std::size_t n) { return compare_word(n, value).equal; });
+}
+
+bitset bit_sliced_index::not_equal(uint64_t value) const {
+  return evaluate([this, value](std::size_t n) { return ~compare_word(n, value).equal; });
+}
+
+bitset bit_sliced_index::less(uint64_t value) const {
+  return evaluate([this, value](std::size_t n) { return compare_word(n, value).less; });
+}
+
+bitset bit_sliced_index::less_equal(uint64_t value) const {
+  return evaluate([this, value](std::size_t n) {
+    comparison c = compare_word(n, value);
+    return c.less | c.equal;
+  });
+}
+
+bitset bit_sliced_index::greater(uint64_t value) const {
+  return evaluate([this, value](std::size_t n) {
+    comparison c = compare_word(n, value);
+    return ~(c.less | c.equal);
+  });
+}
+
+bitset bit_sliced_index::greater_equal(uint64_t value) const {
+  return evaluate([this, value](std::size_t n) { return ~compare_word(n, value).less; });
+}
+
+bitset bit_sliced_index::between(uint64_t lo, uint64_t hi) const {
+  return evaluate([this, lo, hi](std::size_t n) { return ~compare_word(n, lo).less & compare_word(n, hi).less; });
+}
+
+uint64_t bit_sliced_index::sum(const bitset::const_view& filter) const {
+  uint64_t result = 0;
+  for (std::size_t j = 0; j < slices(); ++j) {
+    result += uint64_t(and_count(slices_[j], filter)) << j;
+  }
+  return result;
+}
+
+uint64_t bit_sliced_index::sum() const {
+  uint64_t result = 0;
+  for (std::size_t j = 0; j < slices(); ++j) {
+    result += uint64_t(slices_[j].count()) << j;
+  }
+  return result;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Bit-sliced index over a column of unsigned integers: slice `j` has bit `i`
+// set iff bit `j` of the i-th value is set. Predicates against a constant are
+// evaluated word by word across the slices (O'Neil & Quass), costing
+// O(slices * words) regardless of the data distribution.
+class bit_sliced_index {
+public:
+  bit_sliced_index();
+  explicit bit_sliced_index(std::span<const uint64_t> values);
+
+  std::size_t size() const;
+  bool empty() const;
+
+  // Number of slices: the bit width of the largest value.
+  std::size_t slices() const;
+  bitset::const_view slice(std::size_t bit) const;
+
+  uint64_t value(std::size_t row) const;
+
+  bitset equal(uint64_t value) const;
+  bitset not_equal(uint64_t value) const;
+  bitset less(uint64_t value) const;
+  bitset less_equal(uint64_t value) const;
+  bitset greater(uint64_t value) const;
+  bitset greater_equal(uint64_t value) const;
+
+  // Rows with lo <= x < hi.
+  bitset between(uint64_t lo, uint64_t hi) const;
+
+  // Sum of the values in the rows selected by `filter` (modulo 2^64).
+  uint64_t sum(const bitset::const_view& filter) const;
+  uint64_t sum() const;
+
+private:
+  struct comparison {
+    bitset::word_type less;
+    bitset::word_type equal;
+  };
+
+  comparison compare_word(std::size_t n, uint64_t value) const;
+
+  template <typename Predicate>
+  bitset evaluate(Predicate predicate) const;
+
+private:
+  std::size_t size_;
+  std::vector<bitset> slices_;
+};
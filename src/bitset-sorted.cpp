@@ -0,0 +1,118 @@
+#include "bitset-sorted.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace bitset_sorted {
+namespace {
+using word_type = bitset::word_type;
+
+// Ids are looked up in groups, so the words of a whole group are gathered
+// before any of them is tested.
+constexpr std::size_t PROBE_GROUP = 8;
+
+bool is_dense(const bitset::const_view& bits, std::size_t ids) {
+  return ids * DENSE_WORDS_PER_INDEX >= bits.words_number();
+}
+
+word_type word_at(const bitset::const_view& bits, std::size_t n) {
+  return bits.get_word(n, std::min(bitset_common::WORD_BITS, bits.size() - n * bitset_common::WORD_BITS));
+}
+
+// Calls emit(id, bit) for every id, where `bit` tells whether it is set.
+template <typename Index, typename Emit>
+void probe(const bitset::const_view& bits, std::span<const Index> ids, Emit emit) {
+  std::array<word_type, PROBE_GROUP> words;
+  for (std::size_t first = 0; first < ids.size(); first += PROBE_GROUP) {
+    std::size_t group = std::min(PROBE_GROUP, ids.size() - first);
+    for (std::size_t i = 0; i < group; ++i) {
+      words[i] = word_at(bits, ids[first + i] / bitset_common::WORD_BITS);
+    }
+    for (std::size_t i = 0; i < group; ++i) {
+      Index id = ids[first + i];
+      emit(id, (words[i] >> (id % bitset_common::WORD_BITS)) & 1);
+    }
+  }
+}
+
+// Calls emit(n, ids_mask, word) for every word `n` of the view holding at least
+// one id, where `ids_mask` has the bits of those ids set.
+template <typename Index, typename Emit>
+void merge(const bitset::const_view& bits, std::span<const Index> ids, Emit emit) {
+  std::size_t i = 0;
+  while (i < ids.size()) {
+    std::size_t n = ids[i] / bitset_common::WORD_BITS;
+    word_type mask = 0;
+    for (; i < ids.size() && ids[i] / bitset_common::WORD_BITS == n; ++i) {
+      mask |= bitset_common::ONE << (ids[i] % bitset_common::WORD_BITS);
+    }
+    emit(n, mask, word_at(bits, n));
+  }
+}
+
+template <typename Index>
+void append_bits(std::vector<Index>& result, std::size_t n, word_type word) {
+  for (; word != 0; word &= word - 1) {
+    result.push_back(static_cast<Index>(n * bitset_common::WORD_BITS + std::countr_zero(word)));
+  }
+}
+
+// Selects the ids whose bit equals `wanted`.
+template <typename Index>
+std::vector<Index> select(const bitset::const_view& bits, std::span<const Index> ids, bool wanted) {
+  std::vector<Index> result;
+  if (is_dense(bits, ids.size())) {
+    result.reserve(ids.size());
+    merge(bits, ids, [&result, wanted](std::size_t n, word_type mask, word_type word) {
+      append_bits(result, n, mask & (wanted ? word : ~word));
+    });
+  } else {
+    // Every id is written and the length only advances when it matches.
+    result.resize(ids.size());
+    std::size_t size = 0;
+    probe(bits, ids, [&result, &size, wanted](Index id, bool bit) {
+      result[size] = id;
+      size += (bit == wanted);
+    });
+    result.resize(size);
+  }
+  return result;
+}
+
+template <typename Index>
+std::size_t count(const bitset::const_view& bits, std::span<const Index> ids) {
+  std::size_t result = 0;
+  if (is_dense(bits, ids.size())) {
+    merge(bits, ids, [&result](std::size_t, word_type mask, word_type word) { result += std::popcount(mask & word); });
+  } else {
+    probe(bits, ids, [&result](Index, bool bit) { result += bit; });
+  }
+  return result;
+}
+} // namespace
+
+std::vector<uint32_t> intersect(const bitset::const_view& bits, std::span<const uint32_t> ids) {
+  return select(bits, ids, true);
+}
+
+std::vector<uint64_t> intersect(const bitset::const_view& bits, std::span<const uint64_t> ids) {
+  return select(bits, ids, true);
+}
+
+std::vector<uint32_t> difference(std::span<const uint32_t> ids, const bitset::const_view& bits) {
+  return select(bits, ids, false);
+}
+
+std::vector<uint64_t> difference(std::span<const uint64_t> ids, const bitset::const_view& bits) {
+  return select(bits, ids, false);
+}
+
+std::size_t intersect_count(const bitset::const_view& bits, std::span<const uint32_t> ids) {
+  return count(bits, ids);
+}
+
+std::size_t intersect_count(const bitset::const_view& bits, std::span<const uint64_t> ids) {
+  return count(bits, ids);
+}
+} // namespace bitset_sorted
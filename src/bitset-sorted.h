@@ -0,0 +1,29 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Operations between a bitset view and a strictly increasing list of bit
+// indices. Short lists probe the view one index at a time, without branching
+// on the probed bit; lists that are dense relative to the view are merged
+// word by word instead.
+namespace bitset_sorted {
+// Lists with at least one index per DENSE_WORDS_PER_INDEX words of the view
+// take the word-merging path.
+static constexpr std::size_t DENSE_WORDS_PER_INDEX = 4;
+
+// Indices of `ids` whose bit is set in `bits`.
+std::vector<uint32_t> intersect(const bitset::const_view& bits, std::span<const uint32_t> ids);
+std::vector<uint64_t> intersect(const bitset::const_view& bits, std::span<const uint64_t> ids);
+
+// Indices of `ids` whose bit is not set in `bits`.
+std::vector<uint32_t> difference(std::span<const uint32_t> ids, const bitset::const_view& bits);
+std::vector<uint64_t> difference(std::span<const uint64_t> ids, const bitset::const_view& bits);
+
+std::size_t intersect_count(const bitset::const_view& bits, std::span<const uint32_t> ids);
+std::size_t intersect_count(const bitset::const_view& bits, std::span<const uint64_t> ids);
+} // namespace bitset_sorted
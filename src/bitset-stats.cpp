@@ -0,0 +1,110 @@
+#include "bitset-stats.h"
+
+#include <atomic>
+#include <bit>
+
+namespace bitset_stats {
+namespace {
+using counter = std::atomic<uint64_t>;
+
+struct atomic_op_stats {
+  counter calls;
+  counter aligned_calls;
+  counter unaligned_calls;
+  counter bytes;
+  counter nanoseconds;
+  std::array<counter, HISTOGRAM_BUCKETS> bytes_histogram;
+  std::array<counter, HISTOGRAM_BUCKETS> nanoseconds_histogram;
+};
+
+struct atomic_stats {
+  counter allocations;
+  counter allocated_bytes;
+  std::array<atomic_op_stats, OP_KINDS> ops;
+};
+
+atomic_stats& global_stats() {
+  static atomic_stats stats{};
+  return stats;
+}
+
+uint64_t load(const counter& c) {
+  return c.load(std::memory_order_relaxed);
+}
+
+void load_histogram(const std::array<counter, HISTOGRAM_BUCKETS>& from, histogram& to) {
+  for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+    to[i] = load(from[i]);
+  }
+}
+} // namespace
+
+#ifdef BITSET_ENABLE_STATS
+namespace {
+std::size_t bucket(uint64_t value) {
+  std::size_t result = std::bit_width(value);
+  return result < HISTOGRAM_BUCKETS ? result : HISTOGRAM_BUCKETS - 1;
+}
+
+void add(counter& c, uint64_t value) {
+  c.fetch_add(value, std::memory_order_relaxed);
+}
+} // namespace
+
+void record_allocation(std::size_t bytes) {
+  atomic_stats& stats = global_stats();
+  add(stats.allocations, 1);
+  add(stats.allocated_bytes, bytes);
+}
+
+void record_op(op_kind kind, std::size_t bytes, bool aligned, uint64_t nanoseconds) {
+  atomic_op_stats& op = global_stats().ops[static_cast<std::size_t>(kind)];
+  add(op.calls, 1);
+  add(aligned ? op.aligned_calls : op.unaligned_calls, 1);
+  add(op.bytes, bytes);
+  add(op.nanoseconds, nanoseconds);
+  add(op.bytes_histogram[bucket(bytes)], 1);
+  add(op.nanoseconds_histogram[bucket(nanoseconds)], 1);
+}
+#endif
+
+snapshot take_snapshot() {
+  snapshot result;
+  if constexpr (enabled) {
+    const atomic_stats& stats = global_stats();
+    result.allocations = load(stats.allocations);
+    result.allocated_bytes = load(stats.allocated_bytes);
+    for (std::size_t i = 0; i < OP_KINDS; ++i) {
+      const atomic_op_stats& from = stats.ops[i];
+      op_stats& to = result.ops[i];
+      to.calls = load(from.calls);
+      to.aligned_calls = load(from.aligned_calls);
+      to.unaligned_calls = load(from.unaligned_calls);
+      to.bytes = load(from.bytes);
+      to.nanoseconds = load(from.nanoseconds);
+      load_histogram(from.bytes_histogram, to.bytes_histogram);
+      load_histogram(from.nanoseconds_histogram, to.nanoseconds_histogram);
+    }
+  }
+  return result;
+}
+
+void reset() {
+  if constexpr (enabled) {
+    atomic_stats& stats = global_stats();
+    stats.allocations = 0;
+    stats.allocated_bytes = 0;
+    for (atomic_op_stats& op : stats.ops) {
+      op.calls = 0;
+      op.aligned_calls = 0;
+      op.unaligned_calls = 0;
+      op.bytes = 0;
+      op.nanoseconds = 0;
+      for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        op.bytes_histogram[i] = 0;
+        op.nanoseconds_histogram[i] = 0;
+      }
+    }
+  }
+}
+} // namespace bitset_stats
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Operation statistics are collected only when the library is compiled with
+// BITSET_ENABLE_STATS; otherwise every hook below compiles to nothing.
+namespace bitset_stats {
+#ifdef BITSET_ENABLE_STATS
+static constexpr bool enabled = true;
+#else
+static constexpr bool enabled = false;
+#endif
+
+enum class op_kind : std::size_t {
+  unary,   // flip, set, reset
+  binary,  // &=, |=, ^=, assign
+  scan,    // count, all, any
+  compare, // ==, !=
+  indices, // set/reset/flip/test by index lists
+};
+
+static constexpr std::size_t OP_KINDS = 5;
+static constexpr std::size_t HISTOGRAM_BUCKETS = 48;
+
+// Bucket `i` counts values in [2^(i - 1), 2^i), bucket 0 counts zeros.
+using histogram = std::array<uint64_t, HISTOGRAM_BUCKETS>;
+
+struct op_stats {
+  uint64_t calls = 0;
+  uint64_t aligned_calls = 0;
+  uint64_t unaligned_calls = 0;
+  uint64_t bytes = 0;
+  uint64_t nanoseconds = 0;
+  histogram bytes_histogram{};
+  histogram nanoseconds_histogram{};
+};
+
+struct snapshot {
+  uint64_t allocations = 0;
+  uint64_t allocated_bytes = 0;
+  std::array<op_stats, OP_KINDS> ops{};
+
+  const op_stats& operator[](op_kind kind) const {
+    return ops[static_cast<std::size_t>(kind)];
+  }
+};
+
+snapshot take_snapshot();
+void reset();
+
+#ifdef BITSET_ENABLE_STATS
+void record_allocation(std::size_t bytes);
+void record_op(op_kind kind, std::size_t bytes, bool aligned, uint64_t nanoseconds);
+
+// Times the enclosing bulk operation and records it on destruction.
+class op_scope {
+public:
+  // Operations evaluated at compile time are not recorded.
+  constexpr op_scope(op_kind kind, std::size_t bytes, bool aligned)
+      : kind_(kind)
+      , bytes_(bytes)
+      , aligned_(aligned) {
+    if (!std::is_constant_evaluated()) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  op_scope(const op_scope&) = delete;
+  op_scope& operator=(const op_scope&) = delete;
+
+  constexpr ~op_scope() {
+    if (!std::is_constant_evaluated()) {
+      auto elapsed = std::chrono::steady_clock::now() - start_;
+      record_op(kind_, bytes_, aligned_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+  }
+
+private:
+  op_kind kind_;
+  std::size_t bytes_;
+  bool aligned_;
+  std::chrono::steady_clock::time_point start_;
+};
+#else
+inline void record_allocation(std::size_t) {}
+
+class op_scope {
+public:
+  constexpr op_scope(op_kind, std::size_t, bool) {}
+};
+#endif
+} // namespace bitset_stats
@@ -0,0 +1,116 @@
+#include "bitset-storage.h"
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace bitset_storage {
+namespace {
+std::atomic<bool> prefault_enabled = false;
+
+#ifdef __linux__
+std::size_t mapped_bytes(std::size_t bytes) {
+  return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+// Faults in every page of [data, data + bytes), as huge pages where the kernel
+// has them, by MADV_POPULATE_WRITE or, before Linux 5.14, by writing one byte
+// per huge page.
+void populate(void* data, std::size_t bytes) {
+#ifdef MADV_POPULATE_WRITE
+  if (madvise(data, bytes, MADV_POPULATE_WRITE) == 0) {
+    return;
+  }
+#endif
+  auto* first = static_cast<volatile char*>(data);
+  for (std::size_t offset = 0; offset < bytes; offset += HUGE_PAGE_SIZE) {
+    first[offset] = 0;
+  }
+}
+
+void* map_huge(std::size_t bytes) {
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  int huge_flags = flags | MAP_HUGETLB | (prefault() ? MAP_POPULATE : 0);
+  void* result = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, huge_flags, -1, 0);
+  if (result != MAP_FAILED) {
+    return result;
+  }
+  // No reserved huge pages: fall back to regular pages and ask for
+  // transparent huge pages instead. One extra huge page is mapped and the
+  // excess trimmed so that the buffer starts on a huge page boundary too.
+  // Prefaulting waits until after madvise, or every page would be faulted in
+  // as a small page, the trimmed excess included.
+  result = mmap(nullptr, bytes + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (result == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  auto address = reinterpret_cast<uintptr_t>(result);
+  std::size_t head = (HUGE_PAGE_SIZE - address % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+  if (head != 0) {
+    munmap(result, head);
+  }
+  munmap(reinterpret_cast<char*>(address + head + bytes), HUGE_PAGE_SIZE - head);
+  result = reinterpret_cast<void*>(address + head);
+  madvise(result, bytes, MADV_HUGEPAGE);
+  if (prefault()) {
+    populate(result, bytes);
+  }
+  return result;
+}
+
+bool is_mapped(std::size_t bytes) {
+  return bytes >= HUGE_PAGE_THRESHOLD;
+}
+#endif
+} // namespace
+
+void set_prefault(bool enabled) {
+  prefault_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool prefault() {
+  return prefault_enabled.load(std::memory_order_relaxed);
+}
+
+bool mapped(std::size_t words) {
+#ifdef __linux__
+  return is_mapped(words * sizeof(bitset_common::word_type));
+#else
+  (void)words;
+  return false;
+#endif
+}
+
+bitset_common::word_type* allocate(std::size_t words) {
+  std::size_t bytes = words * sizeof(bitset_common::word_type);
+  void* result;
+#ifdef __linux__
+  if (is_mapped(bytes)) {
+    result = map_huge(mapped_bytes(bytes));
+  } else {
+    result = ::operator new(bytes, std::align_val_t(ALIGNMENT));
+  }
+#else
+  result = ::operator new(bytes, std::align_val_t(ALIGNMENT));
+#endif
+  return static_cast<bitset_common::word_type*>(result);
+}
+
+void deallocate(bitset_common::word_type* data, std::size_t words) noexcept {
+  if (data == nullptr) {
+    return;
+  }
+  std::size_t bytes = words * sizeof(bitset_common::word_type);
+#ifdef __linux__
+  if (is_mapped(bytes)) {
+    munmap(data, mapped_bytes(bytes));
+    return;
+  }
+#endif
+  ::operator delete(data, std::align_val_t(ALIGNMENT));
+}
+} // namespace bitset_storage
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "bitset-common.h"
+
+#include <cstddef>
+
+// Word storage for bitsets. Small buffers come from aligned operator new; large
+// ones are mapped directly so that they can be backed by huge pages.
+namespace bitset_storage {
+// Cache line size: word loops never straddle a line boundary at the start.
+static constexpr std::size_t ALIGNMENT = 64;
+
+static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t(2) << 20;
+
+// Buffers of at least this many bytes are allocated with mmap, using
+// MAP_HUGETLB if huge pages are reserved and MADV_HUGEPAGE otherwise.
+// Only Linux has this path; elsewhere every buffer uses operator new.
+static constexpr std::size_t HUGE_PAGE_THRESHOLD = std::size_t(8) << 20;
+
+// When enabled, mapped buffers are pre-faulted at allocation (MAP_POPULATE)
+// instead of on first touch. Disabled by default.
+void set_prefault(bool enabled);
+bool prefault();
+
+// Whether allocate(words) maps the buffer. A mapped buffer starts on a
+// HUGE_PAGE_SIZE boundary and shares no page with any other object.
+bool mapped(std::size_t words);
+
+bitset_common::word_type* allocate(std::size_t words);
+void deallocate(bitset_common::word_type* data, std::size_t words) noexcept;
+} // namespace bitset_storage
@@ -0,0 +1,38 @@
+#include "bitset-streaming.h"
+
+#include <atomic>
+
+namespace bitset_streaming {
+namespace {
+std::atomic<policy> global_policy = policy::automatic;
+std::atomic<std::size_t> global_cache_budget = DEFAULT_CACHE_BUDGET;
+} // namespace
+
+void set_policy(policy value) {
+  global_policy.store(value, std::memory_order_relaxed);
+}
+
+policy current_policy() {
+  return global_policy.load(std::memory_order_relaxed);
+}
+
+void set_cache_budget(std::size_t bytes) {
+  global_cache_budget.store(bytes, std::memory_order_relaxed);
+}
+
+std::size_t cache_budget() {
+  return global_cache_budget.load(std::memory_order_relaxed);
+}
+
+bool should_stream(std::size_t bytes) {
+  switch (current_policy()) {
+  case policy::always:
+    return true;
+  case policy::never:
+    return false;
+  case policy::automatic:
+    break;
+  }
+  return bytes > cache_budget();
+}
+} // namespace bitset_streaming
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "bitset-common.h"
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define BITSET_HAS_STREAMING_STORES 1
+#endif
+
+// Out-of-place operations whose working set exceeds the cache budget write
+// their result with non-temporal stores and prefetch their inputs ahead, so a
+// huge result does not evict data that is about to be reused.
+namespace bitset_streaming {
+enum class policy {
+  automatic, // stream when the operation touches more than cache_budget() bytes
+  always,
+  never,
+};
+
+static constexpr std::size_t DEFAULT_CACHE_BUDGET = std::size_t(32) << 20;
+
+// Distance, in words, between the word being written and the prefetched one.
+static constexpr std::size_t PREFETCH_DISTANCE = 128;
+
+static constexpr std::size_t CACHE_LINE_WORDS = 64 / sizeof(bitset_common::word_type);
+
+void set_policy(policy value);
+policy current_policy();
+
+void set_cache_budget(std::size_t bytes);
+std::size_t cache_budget();
+
+// Whether an operation reading and writing `bytes` bytes in total should stream.
+bool should_stream(std::size_t bytes);
+
+inline void prefetch(const bitset_common::word_type* address) {
+#if defined(__GNUC__)
+  __builtin_prefetch(address, 0, 0);
+#elif defined(BITSET_HAS_STREAMING_STORES)
+  _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_NTA);
+#else
+  (void) address;
+#endif
+}
+
+inline void stream_store(bitset_common::word_type* address, bitset_common::word_type value) {
+#ifdef BITSET_HAS_STREAMING_STORES
+  _mm_stream_si64(reinterpret_cast<long long*>(address), static_cast<long long>(value));
+#else
+  *address = value;
+#endif
+}
+
+inline void store_fence() {
+#ifdef BITSET_HAS_STREAMING_STORES
+  _mm_sfence();
+#endif
+}
+
+// Writes load(n) to out[n] for every n < words. With `stream` set, the result
+// bypasses the cache and prefetch(n) is called once per cache line of output,
+// PREFETCH_DISTANCE words ahead.
+template <typename Load, typename Prefetch>
+void generate(bitset_common::word_type* out, std::size_t words, bool stream, Load load, Prefetch prefetch_at) {
+  if (!stream) {
+    for (std::size_t n = 0; n < words; ++n) {
+      out[n] = load(n);
+    }
+    return;
+  }
+  std::size_t n = 0;
+  for (; n + CACHE_LINE_WORDS <= words; n += CACHE_LINE_WORDS) {
+    if (n + PREFETCH_DISTANCE < words) {
+      prefetch_at(n + PREFETCH_DISTANCE);
+    }
+    for (std::size_t i = n; i < n + CACHE_LINE_WORDS; ++i) {
+      stream_store(out + i, load(i));
+    }
+  }
+  for (; n < words; ++n) {
+    stream_store(out + n, load(n));
+  }
+  store_fence();
+}
+} // namespace bitset_streaming
@@ -3,9 +3,18 @@
 #include "bitset-common.h"
 #include "bitset-iterator.h"
 #include "bitset-reference.h"
+#include "bitset-run-iterator.h"
+#include "bitset-stats.h"
 
+#include <algorithm>
 #include <bit>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <type_traits>
 
 template <typename T>
 class bitset_view {
@@ -18,73 +27,103 @@ public:
   using const_iterator = bitset_iterator<const word_type>;
   using view = bitset_view<word_type>;
   using const_view = bitset_view<const word_type>;
+  using run_iterator = bitset_run_iterator<const word_type>;
 
-  bitset_view() = default;
+  constexpr bitset_view() = default;
 
-  bitset_view(bitset_iterator<T> begin, bitset_iterator<T> end)
+  constexpr bitset_view(bitset_iterator<T> begin, bitset_iterator<T> end)
       : begin_(begin)
       , end_(end) {}
 
-  operator bitset_view<const T>() const {
+  constexpr operator bitset_view<const T>() const {
     return {begin_, end_};
   }
 
-  std::size_t size() const {
+  constexpr std::size_t size() const {
     return end() - begin();
   }
 
-  bool empty() const {
+  constexpr bool empty() const {
     return size() == 0;
   }
 
-  reference operator[](std::size_t index) const {
+  constexpr reference operator[](std::size_t index) const {
     return begin()[index];
   }
 
-  iterator begin() const {
+  constexpr iterator begin() const {
     return begin_;
   }
 
-  iterator end() const {
+  constexpr iterator end() const {
     return end_;
   }
 
-  void swap(bitset_view& other) noexcept {
+  constexpr void swap(bitset_view& other) noexcept {
     begin_.swap(other.begin_);
     end_.swap(other.end_);
   }
 
   template <bitset_common::NonConst U = T>
-  view flip() const {
+  constexpr view flip() const {
     return applyUnaryOp([](T x) { return ~x; });
   }
 
   template <bitset_common::NonConst U = T>
-  view set() const {
+  constexpr view set() const {
     return applyUnaryOp([](T) { return bitset_common::ALL_BITS; });
   }
 
   template <bitset_common::NonConst U = T>
-  view reset() const {
+  constexpr view reset() const {
     return applyUnaryOp([](T) { return bitset_common::ZERO; });
   }
 
+  // In-place scans from the start of the view. prefix_or sets every bit from the
+  // first set bit onward; prefix_xor replaces each bit with the parity of the bits
+  // up to and including it; fill_between sets every bit from each odd-numbered set
+  // bit to the next one, inclusive, and to the end for an unmatched last marker.
   template <bitset_common::NonConst U = T>
-  view operator&=(const bitset_view<const T>& other) const {
+  constexpr view prefix_or() const {
+    return applyScanOp(
+        [](T x, T carry) { return bitset_common::lowest_and_above(x) | carry; },
+        [](T scanned, T) { return scanned; }
+    );
+  }
+
+  template <bitset_common::NonConst U = T>
+  constexpr view prefix_xor() const {
+    return applyScanOp(
+        [](T x, T carry) { return bitset_common::parity_scan(x) ^ carry; },
+        [](T scanned, T) { return scanned; }
+    );
+  }
+
+  template <bitset_common::NonConst U = T>
+  constexpr view fill_between() const {
+    return applyScanOp(
+        [](T x, T carry) { return bitset_common::parity_scan(x) ^ carry; },
+        [](T scanned, T x) { return scanned | x; }
+    );
+  }
+
+  template <bitset_common::NonConst U = T>
+  constexpr view operator&=(const bitset_view<const T>& other) const {
     return applyBinaryOp(other, [](T a, T b) { return a & b; });
   }
 
   template <bitset_common::NonConst U = T>
-  view operator|=(const bitset_view<const T>& other) const {
+  constexpr view operator|=(const bitset_view<const T>& other) const {
     return applyBinaryOp(other, [](T a, T b) { return a | b; });
   }
 
   template <bitset_common::NonConst U = T>
-  view operator^=(const bitset_view<const T>& other) const {
+  constexpr view operator^=(const bitset_view<const T>& other) const {
     return applyBinaryOp(other, [](T a, T b) { return a ^ b; });
   }
 
-  bool all() const {
+  constexpr bool all() const {
+    bitset_stats::op_scope stats(bitset_stats::op_kind::scan, words_number() * sizeof(T), word_aligned());
     std::size_t n = 0;
     for (; n + 1 < words_number(); ++n) {
       if (get_word(n) != bitset_common::ALL_BITS) {
@@ -96,7 +135,8 @@ public:
            get_word(n, word_size) == (bitset_common::ALL_BITS >> (bitset_common::WORD_BITS - word_size));
   }
 
-  bool any() const {
+  constexpr bool any() const {
+    bitset_stats::op_scope stats(bitset_stats::op_kind::scan, words_number() * sizeof(T), word_aligned());
     std::size_t n = 0;
     for (; n + 1 < words_number(); ++n) {
       if (get_word(n) != bitset_common::ZERO) {
@@ -107,12 +147,77 @@ public:
     return get_word(n, word_size) != bitset_common::ZERO;
   }
 
+  // Copies the first size() bits of `other`; the two views may overlap.
+  template <bitset_common::NonConst U = T>
+  constexpr view assign(const bitset_view<const T>& other) {
+    bitset_stats::op_scope stats(
+        bitset_stats::op_kind::binary,
+        words_number() * sizeof(T),
+        word_aligned() && other.word_aligned()
+    );
+    if (empty()) {
+      return *this;
+    }
+    if (std::is_constant_evaluated()) {
+      copyBuffered(other);
+    } else if (begin_.bit_index_ == other.begin_.bit_index_) {
+      moveCongruent(other);
+    } else if (startsAfter(other)) {
+      copyBackward(other);
+    } else {
+      copyForward(other);
+    }
+    return *this;
+  }
+
+  template <bitset_common::NonConst U = T>
+  constexpr view set_indices(std::span<const uint32_t> indices) const {
+    return applyIndexOp(indices, [](T word, T bit) { return word | bit; });
+  }
+
+  template <bitset_common::NonConst U = T>
+  constexpr view set_indices(std::span<const uint64_t> indices) const {
+    return applyIndexOp(indices, [](T word, T bit) { return word | bit; });
+  }
+
+  template <bitset_common::NonConst U = T>
+  constexpr view reset_indices(std::span<const uint32_t> indices) const {
+    return applyIndexOp(indices, [](T word, T bit) { return word & ~bit; });
+  }
+
+  template <bitset_common::NonConst U = T>
+  constexpr view reset_indices(std::span<const uint64_t> indices) const {
+    return applyIndexOp(indices, [](T word, T bit) { return word & ~bit; });
+  }
+
+  template <bitset_common::NonConst U = T>
+  constexpr view flip_indices(std::span<const uint32_t> indices) const {
+    return applyIndexOp(indices, [](T word, T bit) { return word ^ bit; });
+  }
+
   template <bitset_common::NonConst U = T>
-  view assign(const bitset_view<const T>& other) {
-    return applyBinaryOp(other, [](T, T b) { return b; });
+  constexpr view flip_indices(std::span<const uint64_t> indices) const {
+    return applyIndexOp(indices, [](T word, T bit) { return word ^ bit; });
+  }
+
+  constexpr void test_indices(std::span<const uint32_t> indices, std::span<bool> out) const {
+    gatherIndices(indices, [&out](std::size_t i, bool value) { out[i] = value; });
   }
 
-  std::size_t count() const {
+  constexpr void test_indices(std::span<const uint64_t> indices, std::span<bool> out) const {
+    gatherIndices(indices, [&out](std::size_t i, bool value) { out[i] = value; });
+  }
+
+  constexpr void test_indices(std::span<const uint32_t> indices, const bitset_view<std::remove_const_t<T>>& out) const {
+    gatherIndicesPacked(indices, out);
+  }
+
+  constexpr void test_indices(std::span<const uint64_t> indices, const bitset_view<std::remove_const_t<T>>& out) const {
+    gatherIndicesPacked(indices, out);
+  }
+
+  constexpr std::size_t count() const {
+    bitset_stats::op_scope stats(bitset_stats::op_kind::scan, words_number() * sizeof(T), word_aligned());
     std::size_t result = 0;
     std::size_t n = 0;
     for (; n + 1 < words_number(); ++n) {
@@ -123,7 +228,37 @@ public:
     return result;
   }
 
-  view subview(std::size_t offset = 0, std::size_t count = -1) const {
+  // Maximal runs of `value` bits as (start, length) pairs, in increasing order.
+  constexpr std::ranges::subrange<run_iterator, std::default_sentinel_t> runs(bool value = true) const {
+    return {run_iterator(begin(), size(), value), std::default_sentinel};
+  }
+
+  // Number of maximal runs of `value` bits: the bits equal to `value` whose
+  // lower neighbour is not, counted a word at a time.
+  constexpr std::size_t count_runs(bool value = true) const {
+    bitset_stats::op_scope stats(bitset_stats::op_kind::scan, words_number() * sizeof(T), word_aligned());
+    bitset_common::word_type invert = value ? bitset_common::ZERO : bitset_common::ALL_BITS;
+    bitset_common::word_type carry = 0;
+    std::size_t result = 0;
+    for (std::size_t n = 0; n < words_number(); ++n) {
+      std::size_t bits = std::min(bitset_common::WORD_BITS, size() - n * bitset_common::WORD_BITS);
+      bitset_common::word_type word = (get_word(n, bits) ^ invert) & bitset_common::low_bits(bits);
+      result += std::popcount(word & ~((word << 1) | carry));
+      carry = word >> (bitset_common::WORD_BITS - 1);
+    }
+    return result;
+  }
+
+  // Sets the bits of every run; runs must lie within the view and may overlap.
+  template <bitset_common::NonConst U = T>
+  constexpr view set_runs(std::span<const bitset_run> runs) const {
+    for (const bitset_run& run : runs) {
+      subview(run.start, run.length).set();
+    }
+    return *this;
+  }
+
+  constexpr view subview(std::size_t offset = 0, std::size_t count = -1) const {
     if (offset > size()) {
       return {end(), end()};
     }
@@ -133,28 +268,112 @@ public:
     return {begin() + offset, end()};
   }
 
-  word_type get_word(std::size_t word_num = 0, std::size_t bits = bitset_common::WORD_BITS) const {
+  constexpr word_type get_word(std::size_t word_num = 0, std::size_t bits = bitset_common::WORD_BITS) const {
     return bits == 0 ? 0 : begin().get_word(word_num, bits);
   }
 
-  std::size_t words_number() const {
+  constexpr std::size_t words_number() const {
     return (size() + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS;
   }
 
+  constexpr bool word_aligned() const {
+    return begin_.bit_index_ == 0;
+  }
+
+  // Overwrites `bits` bits starting at bit `word_num * WORD_BITS` of the view with
+  // the low bits of `value`; the counterpart of get_word.
+  template <bitset_common::NonConst U = T>
+  constexpr void
+  set_word(word_type value, std::size_t word_num = 0, std::size_t bits = bitset_common::WORD_BITS) const {
+    if (bits > 0) {
+      begin().set_word(value & bitset_common::low_bits(bits), word_num, bits);
+    }
+  }
+
 private:
   friend class bitset;
 
   template <typename K>
   friend class bitset_view;
 
-  void set_word(word_type value, std::size_t word_num = 0, std::size_t bits = bitset_common::WORD_BITS) const {
-    if (bits > 0) {
-      begin().set_word(value, word_num, bits);
+  constexpr bool startsAfter(const bitset_view<const T>& other) const {
+    const T* this_ptr = begin_.word_ptr_;
+    const T* other_ptr = other.begin_.word_ptr_;
+    if (this_ptr == other_ptr) {
+      return begin_.bit_index_ > other.begin_.bit_index_;
     }
+    return std::less<const T*>()(other_ptr, this_ptr);
+  }
+
+  // Source and destination share the bit offset within a word: whole words are
+  // moved with memmove and only the boundary words need masking. Both boundary
+  // source words are read before anything is written, so overlap is harmless.
+  constexpr void moveCongruent(const bitset_view<const T>& other) const {
+    T* dst = begin_.word_ptr_;
+    const T* src = other.begin_.word_ptr_;
+    std::size_t offset = begin_.bit_index_;
+    std::size_t last = (offset + size() - 1) / bitset_common::WORD_BITS;
+    bitset_common::word_type head_mask = bitset_common::ALL_BITS << offset;
+    bitset_common::word_type tail_mask = bitset_common::low_bits(offset + size() - last * bitset_common::WORD_BITS);
+    if (last == 0) {
+      bitset_common::word_type mask = head_mask & tail_mask;
+      dst[0] = (dst[0] & ~mask) | (src[0] & mask);
+      begin_.markDirty(dst);
+      return;
+    }
+    bitset_common::word_type head = src[0];
+    bitset_common::word_type tail = src[last];
+    std::memmove(dst + 1, src + 1, (last - 1) * sizeof(T));
+    dst[0] = (dst[0] & ~head_mask) | (head & head_mask);
+    dst[last] = (dst[last] & ~tail_mask) | (tail & tail_mask);
+    begin_.markDirty(dst, last + 1);
+  }
+
+  // Funnel-shifting copies. Going forward is safe when the destination starts
+  // before the source, backward when it starts after it: every written chunk
+  // only overlaps source chunks that have already been read.
+  constexpr void copyForward(const bitset_view<const T>& other) const {
+    std::size_t n = 0;
+    for (; n + 1 < words_number(); ++n) {
+      set_word(other.get_word(n), n);
+    }
+    std::size_t word_size = size() - bitset_common::WORD_BITS * n;
+    set_word(other.get_word(n, word_size), n, word_size);
+  }
+
+  constexpr void copyBackward(const bitset_view<const T>& other) const {
+    std::size_t n = words_number() - 1;
+    std::size_t word_size = size() - bitset_common::WORD_BITS * n;
+    set_word(other.get_word(n, word_size), n, word_size);
+    while (n-- > 0) {
+      set_word(other.get_word(n), n);
+    }
+  }
+
+  // Constant evaluation can neither memmove nor order pointers into different
+  // allocations, so the source is read out in full before anything is written.
+  constexpr void copyBuffered(const bitset_view<const T>& other) const {
+    std::size_t words = words_number();
+    std::size_t last_bits = size() - bitset_common::WORD_BITS * (words - 1);
+    T* buffer = new T[words];
+    for (std::size_t n = 0; n + 1 < words; ++n) {
+      buffer[n] = other.get_word(n);
+    }
+    buffer[words - 1] = other.get_word(words - 1, last_bits);
+    for (std::size_t n = 0; n + 1 < words; ++n) {
+      set_word(buffer[n], n);
+    }
+    set_word(buffer[words - 1], words - 1, last_bits);
+    delete[] buffer;
   }
 
   template <bitset_common::NonConst U = T, typename Func>
-  view applyBinaryOp(const bitset_view<const T>& other, Func op) const {
+  constexpr view applyBinaryOp(const bitset_view<const T>& other, Func op) const {
+    bitset_stats::op_scope stats(
+        bitset_stats::op_kind::binary,
+        words_number() * sizeof(T),
+        word_aligned() && other.word_aligned()
+    );
     std::size_t n = 0;
     for (; n + 1 < words_number(); ++n) {
       auto word1 = get_word(n);
@@ -169,7 +388,8 @@ private:
   }
 
   template <bitset_common::NonConst U = T, typename Func>
-  view applyUnaryOp(Func op) const {
+  constexpr view applyUnaryOp(Func op) const {
+    bitset_stats::op_scope stats(bitset_stats::op_kind::unary, words_number() * sizeof(T), word_aligned());
     if (!empty()) {
       std::size_t n = 0;
       for (; n + 1 < words_number(); ++n) {
@@ -187,6 +407,78 @@ private:
     return *this;
   }
 
+  // Words are scanned in order; `carry` is all ones when the last bit of the
+  // previous word's scan is set, so a scan only needs one word of state. The
+  // word written back is finish(scanned, original).
+  template <bitset_common::NonConst U = T, typename Scan, typename Finish>
+  constexpr view applyScanOp(Scan scan, Finish finish) const {
+    bitset_stats::op_scope stats(bitset_stats::op_kind::unary, words_number() * sizeof(T), word_aligned());
+    T carry = bitset_common::ZERO;
+    for (std::size_t n = 0; n < words_number(); ++n) {
+      std::size_t word_size = std::min(bitset_common::WORD_BITS, size() - bitset_common::WORD_BITS * n);
+      T word = get_word(n, word_size);
+      T scanned = scan(word, carry);
+      set_word(finish(scanned, word), n, word_size);
+      carry = bitset_common::ZERO - ((scanned >> (word_size - 1)) & 1);
+    }
+    return *this;
+  }
+
+  // Consecutive indices that fall into the same word are applied to a cached copy of
+  // that word, so sorted input costs one load and one store per touched word.
+  template <bitset_common::NonConst U = T, typename Index, typename Func>
+  constexpr view applyIndexOp(std::span<const Index> indices, Func op) const {
+    bitset_stats::op_scope stats(bitset_stats::op_kind::indices, indices.size_bytes(), word_aligned());
+    if (indices.empty()) {
+      return *this;
+    }
+    T* data = begin_.word_ptr_;
+    std::size_t offset = begin_.bit_index_;
+    std::size_t curr_word_num = (offset + indices[0]) / bitset_common::WORD_BITS;
+    T curr_word = data[curr_word_num];
+    for (Index index : indices) {
+      std::size_t pos = offset + index;
+      std::size_t word_num = pos / bitset_common::WORD_BITS;
+      if (word_num != curr_word_num) {
+        data[curr_word_num] = curr_word;
+        begin_.markDirty(data + curr_word_num);
+        curr_word_num = word_num;
+        curr_word = data[curr_word_num];
+      }
+      curr_word = op(curr_word, bitset_common::ONE << (pos % bitset_common::WORD_BITS));
+    }
+    data[curr_word_num] = curr_word;
+    begin_.markDirty(data + curr_word_num);
+    return *this;
+  }
+
+  template <typename Index, typename Func>
+  constexpr void gatherIndices(std::span<const Index> indices, Func consume) const {
+    bitset_stats::op_scope stats(bitset_stats::op_kind::indices, indices.size_bytes(), word_aligned());
+    const T* data = begin_.word_ptr_;
+    std::size_t offset = begin_.bit_index_;
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+      std::size_t pos = offset + indices[i];
+      consume(i, (data[pos / bitset_common::WORD_BITS] >> (pos % bitset_common::WORD_BITS)) & 1);
+    }
+  }
+
+  template <typename Index>
+  constexpr void
+  gatherIndicesPacked(std::span<const Index> indices, const bitset_view<std::remove_const_t<T>>& out) const {
+    bitset_common::word_type result = 0;
+    gatherIndices(indices, [&out, &result](std::size_t i, bool value) {
+      std::size_t bit = i % bitset_common::WORD_BITS;
+      result |= bitset_common::word_type(value) << bit;
+      if (bit + 1 == bitset_common::WORD_BITS) {
+        out.set_word(result, i / bitset_common::WORD_BITS);
+        result = 0;
+      }
+    });
+    std::size_t tail = indices.size() % bitset_common::WORD_BITS;
+    out.set_word(result, indices.size() / bitset_common::WORD_BITS, tail);
+  }
+
   iterator begin_;
   iterator end_;
 };
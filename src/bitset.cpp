@@ -1,198 +1,124 @@
 #include "bitset.h"
 
+#include "bitset-algorithm.h"
 #include "bitset-iterator.h"
 #include "bitset-reference.h"
+#include "bitset-stats.h"
+#include "bitset-storage.h"
+#include "bitset-streaming.h"
 #include "bitset-view.h"
 
 #include <algorithm>
+#include <bit>
 
-bitset::bitset()
-    : size_(0)
-    , capacity_(0)
-    , data_(nullptr) {}
-
-bitset::bitset(std::size_t size)
-    : size_(size)
-    , capacity_((size + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS)
-    , data_(empty() ? nullptr : new word_type[capacity()]) {}
-
-bitset::bitset(std::size_t size, bool value)
-    : bitset(size) {
-  if (!empty()) {
-    std::fill(data(), data() + capacity(), value ? -1 : 0);
-  }
-}
-
-bitset::bitset(const bitset& other)
-    : bitset(other.size()) {
-  std::copy_n(other.data(), other.capacity(), data());
+void bitset::copyWords(const bitset& other) {
+  const word_type* src = other.data();
+  bitset_streaming::generate(
+      data(),
+      capacity(),
+      bitset_streaming::should_stream(2 * capacity() * sizeof(word_type)),
+      [src](std::size_t n) { return src[n]; },
+      [src](std::size_t n) { bitset_streaming::prefetch(src + n); }
+  );
 }
 
-bitset::bitset(std::string_view str)
-    : bitset(str.size()) {
-  for (std::size_t i = 0; i < str.size(); ++i) {
-    (*this)[i] = (str[i] == '1');
-  }
-}
-
-bitset::bitset(const bitset::const_view& other)
-    : bitset(other.size()) {
-  std::copy(other.begin(), other.end(), begin());
-}
-
-bitset::bitset(bitset::const_iterator first, bitset::const_iterator last)
-    : bitset(last - first) {
-  subview().assign(bitset_view(first, last));
-}
-
-bitset::~bitset() {
-  delete[] data_;
-}
-
-bitset& bitset::operator=(const bitset& other) & {
-  if (&other != this) {
-    bitset tmp(other);
+bitset& bitset::operator>>=(std::size_t count) & {
+  if (size() <= count) {
+    bitset tmp;
     swap(tmp);
+    return *this;
   }
-  return *this;
-}
-
-bitset& bitset::operator=(std::string_view str) & {
-  bitset tmp(str);
+  bitset tmp(subview(0, size() - count));
   swap(tmp);
   return *this;
 }
 
-bitset& bitset::operator=(const bitset::const_view& other) & {
-  bitset tmp(other);
+bitset& bitset::operator<<=(std::size_t count) & {
+  bitset tmp(size() + count, false);
+  tmp.subview(0, size()).assign(subview());
   swap(tmp);
   return *this;
 }
 
-void bitset::swap(bitset& other) noexcept {
-  std::swap(data_, other.data_);
-  std::swap(size_, other.size_);
-  std::swap(capacity_, other.capacity_);
-}
-
-std::size_t bitset::size() const {
-  return size_;
-}
-
-bool bitset::empty() const {
-  return size() == 0;
-}
-
-bitset::iterator bitset::begin() {
-  return {data_, 0};
-}
-
-bitset::const_iterator bitset::begin() const {
-  return {data_, 0};
-}
-
-bitset::iterator bitset::end() {
-  return begin() + size();
-}
-
-bitset::const_iterator bitset::end() const {
-  return begin() + size();
-}
-
-bitset& bitset::operator&=(const bitset::const_view& other) & {
-  subview() &= other.subview();
+bitset& bitset::prefix_or() & {
+  subview().prefix_or();
   return *this;
 }
 
-bitset& bitset::operator|=(const bitset::const_view& other) & {
-  subview() |= other.subview();
+bitset& bitset::prefix_xor() & {
+  subview().prefix_xor();
   return *this;
 }
 
-bitset& bitset::operator^=(const bitset::const_view& other) & {
-  subview() ^= other.subview();
+bitset& bitset::fill_between() & {
+  subview().fill_between();
   return *this;
 }
 
-bitset& bitset::operator>>=(std::size_t count) & {
-  if (size() <= count) {
-    bitset tmp;
-    swap(tmp);
-    return *this;
-  }
-  bitset tmp(subview(0, size() - count));
-  swap(tmp);
+bitset& bitset::set_runs(std::span<const bitset_run> runs) & {
+  subview().set_runs(runs);
   return *this;
 }
 
-bitset& bitset::operator<<=(std::size_t count) & {
-  bitset tmp(size() + count, false);
-  tmp.subview(0, size()).assign(subview());
-  swap(tmp);
+bitset& bitset::set_indices(std::span<const uint32_t> indices) & {
+  subview().set_indices(indices);
   return *this;
 }
 
-void bitset::flip() & {
-  subview().flip();
+bitset& bitset::set_indices(std::span<const uint64_t> indices) & {
+  subview().set_indices(indices);
+  return *this;
 }
 
-bitset& bitset::set() & {
-  subview().set();
+bitset& bitset::reset_indices(std::span<const uint32_t> indices) & {
+  subview().reset_indices(indices);
   return *this;
 }
 
-bitset& bitset::reset() & {
-  subview().reset();
+bitset& bitset::reset_indices(std::span<const uint64_t> indices) & {
+  subview().reset_indices(indices);
   return *this;
 }
 
-bool bitset::all() const {
-  return subview().all();
+bitset& bitset::flip_indices(std::span<const uint32_t> indices) & {
+  subview().flip_indices(indices);
+  return *this;
 }
 
-bool bitset::any() const {
-  return subview().any();
+bitset& bitset::flip_indices(std::span<const uint64_t> indices) & {
+  subview().flip_indices(indices);
+  return *this;
 }
 
-std::size_t bitset::count() const {
-  return subview().count();
+void bitset::test_indices(std::span<const uint32_t> indices, std::span<bool> out) const {
+  subview().test_indices(indices, out);
 }
 
-bitset::reference bitset::operator[](std::size_t index) {
-  return {data(), index};
+void bitset::test_indices(std::span<const uint64_t> indices, std::span<bool> out) const {
+  subview().test_indices(indices, out);
 }
 
-bitset::const_reference bitset::operator[](std::size_t index) const {
-  return {data(), index};
+void bitset::test_indices(std::span<const uint32_t> indices, const bitset::view& out) const {
+  subview().test_indices(indices, out);
 }
 
-bitset::operator const_view() const {
-  return {begin(), end()};
+void bitset::test_indices(std::span<const uint64_t> indices, const bitset::view& out) const {
+  subview().test_indices(indices, out);
 }
 
-bitset::operator view() {
-  return {begin(), end()};
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+std::vector<bitset_dirty::range> bitset::dirty_ranges() const {
+  return dirty_->ranges(size());
 }
 
-bitset::view bitset::subview(std::size_t offset, std::size_t count) {
-  if (offset > size()) {
-    return {end(), end()};
-  }
-  if (count != npos && count <= size() - offset) {
-    return {begin() + offset, begin() + offset + count};
-  }
-  return {begin() + offset, end()};
+bool bitset::dirty() const {
+  return dirty_->any();
 }
 
-bitset::const_view bitset::subview(std::size_t offset, std::size_t count) const {
-  if (offset > size()) {
-    return {end(), end()};
-  }
-  if (count != npos && count <= size() - offset) {
-    return {begin() + offset, begin() + offset + count};
-  }
-  return {begin() + offset, end()};
+void bitset::clear_dirty() {
+  dirty_->clear();
 }
+#endif
 
 std::string to_string(const bitset& bs) {
   return to_string(bs.subview());
@@ -206,25 +132,63 @@ void swap(bitset::reference& lhs, bitset::reference& rhs) noexcept {
   lhs.swap(rhs);
 }
 
+template <typename Op>
+bitset bitset::transform(const const_view& lhs, const const_view& rhs, Op op) {
+  bitset_stats::op_scope stats(
+      bitset_stats::op_kind::binary,
+      lhs.words_number() * sizeof(word_type),
+      lhs.word_aligned() && rhs.word_aligned()
+  );
+  bitset result(lhs.size());
+  if (result.empty()) {
+    return result;
+  }
+  std::size_t words = result.capacity();
+  bool stream = bitset_streaming::should_stream(3 * words * sizeof(word_type));
+  const word_type* lhs_data = lhs.begin_.word_ptr_;
+  const word_type* rhs_data = rhs.begin_.word_ptr_;
+  auto prefetch = [lhs_data, rhs_data](std::size_t n) {
+    bitset_streaming::prefetch(lhs_data + n);
+    bitset_streaming::prefetch(rhs_data + n);
+  };
+  // The last word is written separately: it may be partial and has to be masked.
+  if (lhs.word_aligned() && rhs.word_aligned()) {
+    bitset_streaming::generate(
+        result.data(),
+        words - 1,
+        stream,
+        [lhs_data, rhs_data, op](std::size_t n) { return op(lhs_data[n], rhs_data[n]); },
+        prefetch
+    );
+  } else {
+    bitset_streaming::generate(
+        result.data(),
+        words - 1,
+        stream,
+        [&lhs, &rhs, op](std::size_t n) { return op(lhs.get_word(n), rhs.get_word(n)); },
+        prefetch
+    );
+  }
+  std::size_t last_bits = result.size() - (words - 1) * bitset_common::WORD_BITS;
+  word_type last = op(lhs.get_word(words - 1, last_bits), rhs.get_word(words - 1, last_bits));
+  result.data()[words - 1] = last & bitset_common::low_bits(last_bits);
+  return result;
+}
+
 bitset operator&(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset result(lhs);
-  return (result &= rhs);
+  return bitset::transform(lhs, rhs, [](bitset::word_type a, bitset::word_type b) { return a & b; });
 }
 
 bitset operator|(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset result(lhs);
-  return (result |= rhs);
+  return bitset::transform(lhs, rhs, [](bitset::word_type a, bitset::word_type b) { return a | b; });
 }
 
 bitset operator^(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset result(lhs);
-  return (result ^= rhs);
+  return bitset::transform(lhs, rhs, [](bitset::word_type a, bitset::word_type b) { return a ^ b; });
 }
 
 bitset operator~(const bitset::const_view& bs) {
-  bitset other(bs);
-  other.flip();
-  return other;
+  return bitset::transform(bs, bs, [](bitset::word_type a, bitset::word_type) { return ~a; });
 }
 
 bitset operator<<(const bitset::const_view& bs, std::size_t count) {
@@ -238,22 +202,20 @@ bitset operator>>(const bitset::const_view& bs, std::size_t count) {
   return tmp;
 }
 
-bool operator==(const bitset::const_view& left, const bitset::const_view& right) {
-  if (left.size() != right.size()) {
-    return false;
-  }
+std::size_t and_count(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  bitset_stats::op_scope stats(
+      bitset_stats::op_kind::scan,
+      lhs.words_number() * sizeof(bitset::word_type),
+      lhs.word_aligned() && rhs.word_aligned()
+  );
+  std::size_t result = 0;
   std::size_t n = 0;
-  for (; n + 1 < left.words_number(); ++n) {
-    if (left.get_word(n) != right.get_word(n)) {
-      return false;
-    }
+  for (; n + 1 < lhs.words_number(); ++n) {
+    result += std::popcount(lhs.get_word(n) & rhs.get_word(n));
   }
-  std::size_t word_size = left.size() - bitset_common::WORD_BITS * n;
-  return left.get_word(n, word_size) == right.get_word(n, word_size);
-}
-
-bool operator!=(const bitset::const_view& left, const bitset::const_view& right) {
-  return !(left == right);
+  std::size_t word_size = lhs.size() - bitset_common::WORD_BITS * n;
+  result += std::popcount(lhs.get_word(n, word_size) & rhs.get_word(n, word_size));
+  return result;
 }
 
 std::string to_string(const bitset::const_view& bs) {
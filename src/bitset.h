@@ -1,13 +1,24 @@
 #pragma once
 
 #include "bitset-common.h"
+#include "bitset-dirty.h"
 #include "bitset-iterator.h"
 #include "bitset-reference.h"
+#include "bitset-run-iterator.h"
+#include "bitset-stats.h"
+#include "bitset-storage.h"
 #include "bitset-view.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 class bitset {
 public:
@@ -19,71 +30,289 @@ public:
   using const_iterator = bitset_iterator<const word_type>;
   using view = bitset_view<word_type>;
   using const_view = bitset_view<const word_type>;
+  using run_iterator = bitset_run_iterator<const word_type>;
 
   static constexpr std::size_t npos = -1;
 
-  bitset();
-  bitset(std::size_t size, bool value);
-  bitset(const bitset& other);
-  explicit bitset(std::string_view str);
-  explicit bitset(const const_view& other);
-  bitset(const_iterator first, const_iterator last);
+  constexpr bitset()
+      : size_(0)
+      , capacity_(0)
+      , data_(nullptr) {
+    attachTracker();
+  }
+
+  constexpr bitset(std::size_t size, bool value)
+      : bitset(size) {
+    std::fill(data_, data_ + capacity_, value ? bitset_common::ALL_BITS : bitset_common::ZERO);
+  }
+
+  constexpr bitset(const bitset& other)
+      : bitset(other.size()) {
+    if (std::is_constant_evaluated()) {
+      std::copy(other.data_, other.data_ + capacity_, data_);
+    } else {
+      copyWords(other);
+    }
+  }
+
+  constexpr explicit bitset(std::string_view str)
+      : bitset(str.size()) {
+    for (std::size_t i = 0; i < str.size(); ++i) {
+      (*this)[i] = (str[i] == '1');
+    }
+  }
+
+  constexpr explicit bitset(const const_view& other)
+      : bitset(other.size()) {
+    subview().assign(other);
+  }
+
+  constexpr bitset(const_iterator first, const_iterator last)
+      : bitset(const_view(first, last)) {}
+
+  constexpr bitset& operator=(const bitset& other) & {
+    if (&other != this) {
+      bitset tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  constexpr bitset& operator=(std::string_view str) & {
+    bitset tmp(str);
+    swap(tmp);
+    return *this;
+  }
+
+  constexpr bitset& operator=(const const_view& other) & {
+    bitset tmp(other);
+    swap(tmp);
+    return *this;
+  }
+
+  constexpr ~bitset() {
+    if (std::is_constant_evaluated()) {
+      delete[] data_;
+    } else {
+      bitset_storage::deallocate(data_, capacity_);
+    }
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+    delete dirty_;
+#endif
+  }
+
+  constexpr void swap(bitset& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+    std::swap(dirty_, other.dirty_);
+#endif
+  }
 
-  bitset& operator=(const bitset& other) &;
-  bitset& operator=(std::string_view str) &;
-  bitset& operator=(const const_view& other) &;
+  constexpr std::size_t size() const {
+    return size_;
+  }
 
-  ~bitset();
+  constexpr bool empty() const {
+    return size() == 0;
+  }
+
+  constexpr reference operator[](std::size_t index) {
+    return begin()[index];
+  }
 
-  void swap(bitset& other) noexcept;
+  constexpr const_reference operator[](std::size_t index) const {
+    return begin()[index];
+  }
 
-  std::size_t size() const;
-  bool empty() const;
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+  constexpr iterator begin() {
+    return {data_, 0, dirty_};
+  }
 
-  reference operator[](std::size_t index);
-  const_reference operator[](std::size_t index) const;
+  constexpr const_iterator begin() const {
+    return {data_, 0, dirty_};
+  }
+#else
+  constexpr iterator begin() {
+    return {data_, 0};
+  }
 
-  iterator begin();
-  const_iterator begin() const;
+  constexpr const_iterator begin() const {
+    return {data_, 0};
+  }
+#endif
 
-  iterator end();
-  const_iterator end() const;
+  constexpr iterator end() {
+    return begin() + size();
+  }
+
+  constexpr const_iterator end() const {
+    return begin() + size();
+  }
+
+  constexpr bitset& operator&=(const const_view& other) & {
+    subview() &= other;
+    return *this;
+  }
+
+  constexpr bitset& operator|=(const const_view& other) & {
+    subview() |= other;
+    return *this;
+  }
+
+  constexpr bitset& operator^=(const const_view& other) & {
+    subview() ^= other;
+    return *this;
+  }
 
-  bitset& operator&=(const const_view& other) &;
-  bitset& operator|=(const const_view& other) &;
-  bitset& operator^=(const const_view& other) &;
   bitset& operator<<=(std::size_t count) &;
   bitset& operator>>=(std::size_t count) &;
-  void flip() &;
+  constexpr void flip() & {
+    subview().flip();
+  }
+
+  constexpr bitset& set() & {
+    subview().set();
+    return *this;
+  }
+
+  constexpr bitset& reset() & {
+    subview().reset();
+    return *this;
+  }
+
+  bitset& prefix_or() &;
+  bitset& prefix_xor() &;
+  bitset& fill_between() &;
+
+  bitset& set_indices(std::span<const uint32_t> indices) &;
+  bitset& set_indices(std::span<const uint64_t> indices) &;
+  bitset& reset_indices(std::span<const uint32_t> indices) &;
+  bitset& reset_indices(std::span<const uint64_t> indices) &;
+  bitset& flip_indices(std::span<const uint32_t> indices) &;
+  bitset& flip_indices(std::span<const uint64_t> indices) &;
+
+  void test_indices(std::span<const uint32_t> indices, std::span<bool> out) const;
+  void test_indices(std::span<const uint64_t> indices, std::span<bool> out) const;
+  void test_indices(std::span<const uint32_t> indices, const view& out) const;
+  void test_indices(std::span<const uint64_t> indices, const view& out) const;
+
+  constexpr bool all() const {
+    return subview().all();
+  }
+
+  constexpr bool any() const {
+    return subview().any();
+  }
+
+  constexpr std::size_t count() const {
+    return subview().count();
+  }
+
+  constexpr std::ranges::subrange<run_iterator, std::default_sentinel_t> runs(bool value = true) const {
+    return subview().runs(value);
+  }
+
+  constexpr std::size_t count_runs(bool value = true) const {
+    return subview().count_runs(value);
+  }
+
+  bitset& set_runs(std::span<const bitset_run> runs) &;
 
-  bitset& set() &;
-  bitset& reset() &;
+  constexpr operator const_view() const {
+    return {begin(), end()};
+  }
 
-  bool all() const;
-  bool any() const;
-  std::size_t count() const;
+  constexpr operator view() {
+    return {begin(), end()};
+  }
 
-  operator const_view() const;
-  operator view();
+  constexpr view subview(std::size_t offset = 0, std::size_t count = npos) {
+    return view(begin(), end()).subview(offset, count);
+  }
+
+  constexpr const_view subview(std::size_t offset = 0, std::size_t count = npos) const {
+    return const_view(begin(), end()).subview(offset, count);
+  }
 
-  view subview(std::size_t offset = 0, std::size_t count = npos);
-  const_view subview(std::size_t offset = 0, std::size_t count = npos) const;
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+  // Bit ranges written since construction or the last clear_dirty, in whole
+  // bitset_dirty::BLOCK_BITS blocks. Any assignment or resize dirties everything.
+  std::vector<bitset_dirty::range> dirty_ranges() const;
+  bool dirty() const;
+  void clear_dirty();
+#endif
 
 private:
-  bitset(std::size_t size);
+  friend class bit_matrix;
+  friend class bit_writer;
+  friend class bitset_array;
+  friend class blocked_bloom_filter;
+  friend class hamming_index;
+  friend class numa_bitset;
 
-  std::size_t capacity() const {
+  friend bitset operator&(const const_view& lhs, const const_view& rhs);
+  friend bitset operator|(const const_view& lhs, const const_view& rhs);
+  friend bitset operator^(const const_view& lhs, const const_view& rhs);
+  friend bitset operator~(const const_view& bs);
+
+  // Leaves the words uninitialized. Storage comes from bitset_storage at run time
+  // and from plain new[] during constant evaluation.
+  constexpr bitset(std::size_t size)
+      : size_(size)
+      , capacity_((size + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS)
+      , data_(nullptr) {
+    if (std::is_constant_evaluated()) {
+      data_ = new word_type[capacity_]();
+    } else if (!empty()) {
+      data_ = bitset_storage::allocate(capacity_);
+      bitset_stats::record_allocation(capacity_ * sizeof(word_type));
+    }
+    attachTracker();
+  }
+
+  void copyWords(const bitset& other);
+
+  constexpr void attachTracker() {
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+    if (!std::is_constant_evaluated()) {
+      try {
+        dirty_ = new bitset_dirty::tracker(data_, capacity_);
+      } catch (...) {
+        bitset_storage::deallocate(data_, capacity_);
+        throw;
+      }
+    }
+#endif
+  }
+
+  template <typename Op>
+  static bitset transform(const const_view& lhs, const const_view& rhs, Op op);
+
+  constexpr std::size_t capacity() const {
     return capacity_;
   }
 
-  word_type* data() const {
+  constexpr word_type* data() const {
     return data_;
   }
 
+  // For friends storing through data() into words that existed before the call.
+  void mark_dirty([[maybe_unused]] const word_type* first, [[maybe_unused]] std::size_t words) const {
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+    dirty_->mark(first, words);
+#endif
+  }
+
 private:
   std::size_t size_;
   std::size_t capacity_;
   word_type* data_;
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+  bitset_dirty::tracker* dirty_ = nullptr;
+#endif
 };
 
 void swap(bitset& lhs, bitset& rhs) noexcept;
@@ -98,8 +327,32 @@ bitset operator~(const bitset::const_view& bs);
 bitset operator<<(const bitset::const_view& bs, std::size_t count);
 bitset operator>>(const bitset::const_view& bs, std::size_t count);
 
-bool operator==(const bitset::const_view& left, const bitset::const_view& right);
-bool operator!=(const bitset::const_view& left, const bitset::const_view& right);
+// Number of bits set in both views, computed without materializing `lhs & rhs`.
+std::size_t and_count(const bitset::const_view& lhs, const bitset::const_view& rhs);
+
+constexpr bool operator==(const bitset::const_view& left, const bitset::const_view& right) {
+  if (left.size() != right.size()) {
+    return false;
+  }
+  bitset_stats::op_scope stats(
+      bitset_stats::op_kind::compare,
+      left.words_number() * sizeof(bitset::word_type),
+      left.word_aligned() && right.word_aligned()
+  );
+  std::size_t n = 0;
+  for (; n + 1 < left.words_number(); ++n) {
+    if (left.get_word(n) != right.get_word(n)) {
+      return false;
+    }
+  }
+  std::size_t word_size = left.size() - bitset_common::WORD_BITS * n;
+  return left.get_word(n, word_size) == right.get_word(n, word_size);
+}
+
+constexpr bool operator!=(const bitset::const_view& left, const bitset::const_view& right) {
+  return !(left == right);
+}
+
 std::string to_string(const bitset::const_view& bs);
 std::string to_string(const bitset& bs);
 std::ostream& operator<<(std::ostream& out, const bitset::const_view& bs);
@@ -0,0 +1,104 @@
+#include "bitset-algorithm.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace {
+const std::string STR = "1111011011101000010010111110100001101111111100000110011001001000101110010011010100000000"
+                        "000000000000000000000000000000000000000000000000001111111111111111111111111111111111111111"
+                        "1111111111111111111111111111";
+} // namespace
+
+TEST_CASE("bitset_algo::copy") {
+  const bitset src(STR);
+  std::size_t from = GENERATE(0, 3, 64, 70);
+  std::size_t to = GENERATE(0, 1, 70);
+  std::size_t length = GENERATE(0, 5, 64, 130);
+  CAPTURE(from, to, length);
+
+  bitset dst(300, false);
+  auto result = bitset_algo::copy(src.begin() + from, src.begin() + from + length, dst.begin() + to);
+
+  CHECK(result == dst.begin() + to + length);
+  CHECK(dst.subview(to, length) == src.subview(from, length));
+  CHECK(dst.count() == src.subview(from, length).count());
+}
+
+TEST_CASE("bitset_algo::fill and count") {
+  bitset bs(STR);
+  std::size_t from = GENERATE(0, 7, 64);
+  std::size_t length = GENERATE(0, 1, 63, 130);
+  bool value = GENERATE(false, true);
+  CAPTURE(from, length, value);
+
+  auto first = bs.begin() + from;
+  auto last = first + length;
+  bitset_algo::fill(first, last, value);
+
+  CHECK(bitset_algo::count(first, last, value) == length);
+  CHECK(bitset_algo::count(first, last, !value) == 0);
+  CHECK(bitset_algo::count(bs.begin(), bs.end(), true) == std::count(bs.begin(), bs.end(), true));
+}
+
+TEST_CASE("bitset_algo::find") {
+  const bitset bs(STR);
+  std::size_t from = GENERATE(0, 5, 64, 90, 150);
+  bool value = GENERATE(false, true);
+  CAPTURE(from, value);
+
+  auto first = bs.begin() + from;
+  CHECK(bitset_algo::find(first, bs.end(), value) == std::find(first, bs.end(), value));
+  CHECK(bitset_algo::find(first, first, value) == first);
+}
+
+TEST_CASE("bitset_algo::mismatch and equal") {
+  bitset bs_1(STR);
+  bitset bs_2(STR);
+  std::size_t flipped = GENERATE(0, 63, 64, 200);
+  CAPTURE(flipped);
+
+  bs_2[flipped].flip();
+
+  auto [it_1, it_2] = bitset_algo::mismatch(bs_1.begin(), bs_1.end(), std::as_const(bs_2).begin());
+  CHECK(it_1 == bs_1.begin() + flipped);
+  CHECK(it_2 == std::as_const(bs_2).begin() + flipped);
+
+  CHECK(bitset_algo::equal(bs_1.begin(), bs_1.begin() + flipped, bs_2.begin()));
+  CHECK_FALSE(bitset_algo::equal(bs_1.begin(), bs_1.end(), bs_2.begin(), bs_2.end()));
+  CHECK(bitset_algo::equal(bs_1.begin() + 1, bs_1.begin() + 1, bs_2.begin()));
+
+  bs_2[flipped].flip();
+  CHECK(bitset_algo::equal(bs_1.begin(), bs_1.end(), bs_2.begin(), bs_2.end()));
+  CHECK(bitset_algo::mismatch(bs_1.begin(), bs_1.end(), bs_2.begin()).first == bs_1.end());
+}
+
+TEST_CASE("bitset_algo::copy_bits") {
+  SECTION("disjoint") {
+    const bitset src(STR);
+    bitset dst(STR.size() + 10, false);
+    bitset::view written = bitset_algo::copy_bits(src.subview(3, 100), dst.subview(10));
+    CHECK(written.size() == 100);
+    CHECK(dst.subview(10, 100) == src.subview(3, 100));
+    CHECK(dst.count() == src.subview(3, 100).count());
+  }
+
+  SECTION("overlapping") {
+    std::size_t from = GENERATE(0, 1, 5, 63, 64, 65, 128);
+    std::size_t to = GENERATE(0, 1, 5, 63, 64, 65, 128);
+    std::size_t length = GENERATE(1, 10, 64, 70);
+    CAPTURE(from, to, length);
+
+    bitset bs(STR);
+    std::string expected = STR;
+    std::copy_n(STR.begin() + from, length, expected.begin() + to);
+
+    bitset_algo::copy_bits(std::as_const(bs).subview(from, length), bs.subview(to, length));
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+}
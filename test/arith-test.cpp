@@ -0,0 +1,149 @@
+#include "bitset-arith.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstdint>
+#include <random>
+
+namespace {
+// Bit-by-bit ripple carry addition; `rhs` is zero-extended.
+bool naive_add(const bitset::view& lhs, const bitset::const_view& rhs, bool carry) {
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    int sum = lhs[i] + (i < rhs.size() && rhs[i]) + carry;
+    lhs[i] = (sum & 1) != 0;
+    carry = sum > 1;
+  }
+  return carry;
+}
+
+bool naive_sub(const bitset::view& lhs, const bitset::const_view& rhs, bool borrow) {
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    int difference = lhs[i] - (i < rhs.size() && rhs[i]) - borrow;
+    lhs[i] = (difference & 1) != 0;
+    borrow = difference < 0;
+  }
+  return borrow;
+}
+
+// Shift-and-add product of `value` and `factor` with 64 extra bits.
+bitset naive_mul(const bitset::const_view& value, uint64_t factor) {
+  bitset result(value.size() + 64, false);
+  bitset shifted(value.size() + 64, false);
+  shifted.subview(0, value.size()).assign(value);
+  for (; factor != 0; factor >>= 1) {
+    if ((factor & 1) != 0) {
+      naive_add(result, shifted, false);
+    }
+    bitset copy(shifted);
+    naive_add(shifted, copy, false);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("big integer arithmetic") {
+  std::mt19937 gen(37);
+  std::size_t size = GENERATE(1, 63, 64, 65, 200, 1000);
+  std::size_t offset = GENERATE(0, 5);
+  CAPTURE(size, offset);
+
+  bitset lhs_storage = random_bitset(size + offset, gen);
+  bitset rhs_storage = random_bitset(size + 3, gen);
+  bitset::view lhs = lhs_storage.subview(offset);
+  bitset::const_view rhs = rhs_storage.subview(3);
+
+  SECTION("add") {
+    for (bool carry : {false, true}) {
+      bitset expected(lhs);
+      bool expected_carry = naive_add(expected, rhs, carry);
+      bitset actual(lhs);
+      CHECK(bitset_arith::add_assign(actual, rhs, carry) == expected_carry);
+      CHECK(actual == expected);
+    }
+    bitset doubled(lhs);
+    bitset expected(lhs);
+    CHECK(bitset_arith::add_assign(doubled, doubled) == naive_add(expected, lhs, false));
+    CHECK(doubled == expected);
+  }
+
+  SECTION("subtract") {
+    for (bool borrow : {false, true}) {
+      bitset expected(lhs);
+      bool expected_borrow = naive_sub(expected, rhs, borrow);
+      CHECK(bitset_arith::sub_assign(lhs, rhs, borrow) == expected_borrow);
+      CHECK(lhs == expected);
+      CHECK(bitset_arith::add_assign(lhs, rhs, borrow) == expected_borrow);
+    }
+    CHECK(lhs == lhs_storage.subview(offset));
+  }
+
+  SECTION("shorter operand") {
+    bitset::const_view small = rhs.subview(0, size / 2 + 1);
+    bitset expected(lhs);
+    bool expected_carry = naive_add(expected, small, false);
+    CHECK(bitset_arith::add_assign(lhs, small) == expected_carry);
+    CHECK(lhs == expected);
+    CHECK(bitset_arith::sub_assign(lhs, small) == expected_carry);
+    CHECK(lhs == lhs_storage.subview(offset));
+  }
+
+  SECTION("increment") {
+    bitset expected(lhs);
+    bitset one(1, true);
+    bool expected_carry = naive_add(expected, one, false);
+    CHECK(bitset_arith::increment(lhs) == expected_carry);
+    CHECK(lhs == expected);
+
+    lhs.set();
+    CHECK(bitset_arith::increment(lhs));
+    CHECK_FALSE(lhs.any());
+  }
+
+  SECTION("compare") {
+    CHECK(bitset_arith::compare(lhs, lhs) == std::strong_ordering::equal);
+    bitset bigger(lhs);
+    if (!bitset_arith::increment(bigger)) {
+      CHECK(bitset_arith::compare(lhs, bigger) == std::strong_ordering::less);
+      CHECK(bitset_arith::compare(bigger, lhs) == std::strong_ordering::greater);
+    }
+    bitset extended(size + 100, false);
+    extended.subview(0, size).assign(lhs);
+    CHECK(bitset_arith::compare(lhs, extended) == std::strong_ordering::equal);
+    extended[size + 99] = true;
+    CHECK(bitset_arith::compare(lhs, extended) == std::strong_ordering::less);
+  }
+
+  SECTION("multiply") {
+    for (uint64_t factor : {uint64_t(0), uint64_t(1), uint64_t(3), uint64_t(1000003), ~uint64_t(0)}) {
+      CAPTURE(factor);
+      bitset expected = naive_mul(lhs, factor);
+      bitset actual(lhs);
+      uint64_t overflow = bitset_arith::mul_small(actual, factor);
+      CHECK(actual == expected.subview(0, size));
+      bitset high(64, false);
+      high.subview(0, 64).set_word(overflow, 0);
+      CHECK(high == expected.subview(size));
+    }
+  }
+}
+
+TEST_CASE("big integer arithmetic small values") {
+  bitset value(70, false);
+  value.subview(0, 64).set_word(~uint64_t(0), 0);
+  CHECK_FALSE(bitset_arith::increment(value));
+  CHECK(value.count() == 1);
+  CHECK(value[64]);
+
+  CHECK(bitset_arith::sub_assign(value, bitset(70, true)));
+  CHECK(value.count() == 2);
+  CHECK(value[0]);
+  CHECK(value[64]);
+
+  bitset small(6, false);
+  small.subview().set_word(21, 0, 6);
+  CHECK(bitset_arith::mul_small(small, 5) == 1);
+  CHECK(small.subview().get_word(0, 6) == 105 % 64);
+}
@@ -0,0 +1,157 @@
+#include "bitset-array.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("bitset array") {
+  std::mt19937 gen(29);
+  std::size_t bits = GENERATE(0, 1, 64, 100, 512);
+  CAPTURE(bits);
+
+  std::vector<bitset> rows;
+  for (std::size_t i = 0; i < 50; ++i) {
+    rows.push_back(random_bitset(bits, gen));
+  }
+  bitset_array array(rows);
+  REQUIRE(array.size() == rows.size());
+  CHECK(array.bits() == bits);
+  CHECK(array.stride() == (bits + 63) / 64);
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    REQUIRE(array[i] == rows[i]);
+  }
+
+  SECTION("construction") {
+    bitset_array ones(10, bits, true);
+    bitset_array zeros(10, bits, false);
+    for (std::size_t i = 0; i < 10; ++i) {
+      CHECK(ones[i].count() == bits);
+      CHECK(zeros[i].count() == 0);
+    }
+    CHECK(bitset_array().empty());
+
+    std::vector<bitset> uneven = rows;
+    uneven.push_back(bitset(bits + 1, false));
+    CHECK_THROWS_AS(bitset_array(uneven), std::invalid_argument);
+  }
+
+  SECTION("push back") {
+    bitset_array appended(0, bits, false);
+    bitset storage = random_bitset(bits + 3, gen);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+      appended.push_back(rows[i]);
+    }
+    CHECK(appended == array);
+
+    appended.push_back(storage.subview(3));
+    CHECK(appended[rows.size()] == storage.subview(3));
+    // A row of the array itself survives the reallocation it may trigger.
+    for (std::size_t i = 0; i < 40; ++i) {
+      appended.push_back(appended[i]);
+    }
+    for (std::size_t i = 0; i < 40; ++i) {
+      REQUIRE(appended[rows.size() + 1 + i] == rows[i]);
+    }
+
+    appended.clear();
+    CHECK(appended.empty());
+    appended.reserve(100);
+    appended.push_back(rows[7]);
+    CHECK(appended.size() == 1);
+    CHECK(appended[0] == rows[7]);
+  }
+
+  SECTION("rows are views") {
+    if (bits > 0) {
+      array[3].flip();
+      CHECK(array[3] == ~rows[3]);
+      array[4][bits - 1] = !rows[4][bits - 1];
+      CHECK(array[4].count() != rows[4].count());
+      CHECK(array != bitset_array(rows));
+    }
+  }
+
+  SECTION("or rows") {
+    bitset expected(bits, false);
+    for (const bitset& row : rows) {
+      expected |= row;
+    }
+    CHECK(array.or_rows() == expected);
+    CHECK(bitset_array(0, bits, false).or_rows() == bitset(bits, false));
+  }
+
+  SECTION("counts") {
+    bitset_array ones(5, bits, true);
+    std::vector<std::size_t> out(rows.size());
+    array.counts(out);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+      REQUIRE(out[i] == rows[i].count());
+    }
+    ones.counts(std::span(out).first(5));
+    CHECK(out[4] == bits);
+  }
+
+  SECTION("gather") {
+    std::vector<uint32_t> indices32 = {49, 0, 7, 7, 31, 2, 18, 40, 11, 3, 25, 6};
+    std::vector<uint64_t> indices64(indices32.begin(), indices32.end());
+    bitset_array gathered = array.gather(indices32);
+    REQUIRE(gathered.size() == indices32.size());
+    for (std::size_t i = 0; i < indices32.size(); ++i) {
+      REQUIRE(gathered[i] == rows[indices32[i]]);
+    }
+    CHECK(array.gather(indices64) == gathered);
+    CHECK(array.gather(std::span<const uint32_t>()).empty());
+  }
+
+  SECTION("serialization") {
+    std::stringstream stream;
+    array.serialize(stream);
+    CHECK(stream.str().size() == 16 + rows.size() * array.stride() * sizeof(bitset::word_type));
+    bitset_array restored = bitset_array::deserialize(stream);
+    CHECK(restored == array);
+  }
+
+  SECTION("corrupted serialization") {
+    std::stringstream stream;
+    array.serialize(stream);
+    std::string encoded = stream.str();
+    for (std::size_t length : {std::size_t(0), std::size_t(8), std::size_t(15), encoded.size() - 1}) {
+      CAPTURE(length);
+      std::stringstream truncated(encoded.substr(0, length));
+      CHECK_THROWS_AS(bitset_array::deserialize(truncated), std::invalid_argument);
+    }
+
+    auto with_header = [&encoded](uint64_t header_size, uint64_t header_bits) {
+      std::string result = encoded;
+      std::memcpy(result.data(), &header_size, sizeof(header_size));
+      std::memcpy(result.data() + sizeof(header_size), &header_bits, sizeof(header_bits));
+      return std::stringstream(result);
+    };
+    std::stringstream overflowing = with_header(uint64_t(1) << 40, uint64_t(1) << 40);
+    CHECK_THROWS_AS(bitset_array::deserialize(overflowing), std::invalid_argument);
+    std::stringstream huge_rows = with_header(1, uint64_t(1) << 62);
+    CHECK_THROWS_AS(bitset_array::deserialize(huge_rows), std::invalid_argument);
+    if (bits > 0) {
+      // Rows of no bits take no space, so any number of them is well formed.
+      std::stringstream many_rows = with_header(uint64_t(1) << 40, bits);
+      CHECK_THROWS_AS(bitset_array::deserialize(many_rows), std::invalid_argument);
+    }
+  }
+
+  SECTION("swap") {
+    bitset_array other(3, bits + 1, true);
+    swap(array, other);
+    CHECK(array.size() == 3);
+    CHECK(array.bits() == bits + 1);
+    CHECK(other[5] == rows[5]);
+  }
+}
@@ -0,0 +1,185 @@
+#include "bitset-bitstream.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+enum class field_kind {
+  fixed,
+  unary,
+  gamma,
+};
+
+struct field {
+  field_kind kind;
+  uint64_t value;
+  std::size_t bits;
+};
+
+std::vector<field> random_fields(std::size_t count, std::mt19937_64& gen) {
+  std::vector<field> result;
+  std::uniform_int_distribution<int> kind(0, 2);
+  std::uniform_int_distribution<std::size_t> width(0, 64);
+  std::geometric_distribution<std::size_t> small(0.05);
+  for (std::size_t i = 0; i < count; ++i) {
+    switch (kind(gen)) {
+    case 0: {
+      std::size_t bits = width(gen);
+      uint64_t value = bits == 0 ? 0 : gen() >> (64 - bits);
+      result.push_back({field_kind::fixed, value, bits});
+      break;
+    }
+    case 1:
+      result.push_back({field_kind::unary, small(gen), 0});
+      break;
+    default:
+      result.push_back({field_kind::gamma, (gen() >> width(gen) % 64) | 1, 0});
+      break;
+    }
+  }
+  return result;
+}
+
+// The same encoding, written bit by bit.
+void naive_write(bitset& out, const field& f) {
+  auto push = [&out](bool bit) {
+    bitset grown(out.size() + 1, false);
+    grown.subview(0, out.size()).assign(out);
+    grown[out.size()] = bit;
+    out.swap(grown);
+  };
+  auto push_bits = [&push](uint64_t value, std::size_t bits) {
+    for (std::size_t i = 0; i < bits; ++i) {
+      push(((value >> i) & 1) != 0);
+    }
+  };
+  auto push_unary = [&push](std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      push(false);
+    }
+    push(true);
+  };
+  switch (f.kind) {
+  case field_kind::fixed:
+    push_bits(f.value, f.bits);
+    break;
+  case field_kind::unary:
+    push_unary(f.value);
+    break;
+  case field_kind::gamma: {
+    std::size_t width = std::bit_width(f.value) - 1;
+    push_unary(width);
+    push_bits(f.value, width);
+    break;
+  }
+  }
+}
+} // namespace
+
+TEST_CASE("bit stream round trip") {
+  std::mt19937_64 gen(59);
+  std::size_t count = GENERATE(0, 1, 10, 500);
+  CAPTURE(count);
+  std::vector<field> fields = random_fields(count, gen);
+
+  bit_writer writer;
+  bitset expected;
+  for (const field& f : fields) {
+    switch (f.kind) {
+    case field_kind::fixed:
+      writer.write(f.value, f.bits);
+      break;
+    case field_kind::unary:
+      writer.write_unary(f.value);
+      break;
+    case field_kind::gamma:
+      writer.write_gamma(f.value);
+      break;
+    }
+    naive_write(expected, f);
+    REQUIRE(writer.size() == expected.size());
+  }
+  bitset encoded = writer.release();
+  REQUIRE(encoded == expected);
+  CHECK(writer.size() == 0);
+
+  // Decoding from an unaligned view of the same bits.
+  bitset shifted(encoded.size() + 13, true);
+  shifted.subview(13).assign(encoded);
+  bit_reader reader(shifted.subview(13));
+  for (const field& f : fields) {
+    switch (f.kind) {
+    case field_kind::fixed:
+      REQUIRE(reader.read(f.bits) == f.value);
+      break;
+    case field_kind::unary:
+      REQUIRE(reader.read_unary() == f.value);
+      break;
+    case field_kind::gamma:
+      REQUIRE(reader.read_gamma() == f.value);
+      break;
+    }
+  }
+  CHECK(reader.position() == encoded.size());
+  CHECK(reader.remaining() == 0);
+}
+
+TEST_CASE("bit stream writer") {
+  bit_writer writer;
+  writer.write_bit(true);
+  writer.write_bit(false);
+  writer.write(0b101, 3);
+  CHECK(writer.size() == 5);
+  CHECK(writer.release() == bitset("10101"));
+
+  bitset storage("0011010111000111101010101010101010101010101010101010101010101010101111");
+  writer.write_bits(storage.subview(2));
+  writer.write_bits(bitset::const_view());
+  CHECK(writer.release() == storage.subview(2));
+
+  writer.write_unary(200);
+  bitset unary = writer.release();
+  CHECK(unary.size() == 201);
+  CHECK(unary.count() == 1);
+  CHECK(unary[200]);
+
+  for (std::size_t i = 0; i < 64; ++i) {
+    writer.write(~uint64_t(0), 64);
+  }
+  bitset words = writer.release();
+  CHECK(words.size() == 64 * 64);
+  CHECK(words.all());
+
+  CHECK_THROWS_AS(writer.write_gamma(0), std::invalid_argument);
+  CHECK(writer.release().empty());
+}
+
+TEST_CASE("bit stream reader errors") {
+  bitset bs("0000101");
+  bit_reader reader(bs);
+  CHECK(reader.read_unary() == 4);
+  CHECK_THROWS_AS(reader.read(3), std::out_of_range);
+  CHECK(reader.position() == 5);
+  CHECK(reader.read_bit() == false);
+  CHECK(reader.read_bit() == true);
+  CHECK(reader.read(0) == 0);
+  CHECK_THROWS_AS(reader.read_bit(), std::out_of_range);
+  CHECK_THROWS_AS(reader.read_unary(), std::out_of_range);
+
+  bitset zeros(100, false);
+  bit_reader zeros_reader(zeros);
+  CHECK_THROWS_AS(zeros_reader.read_unary(), std::out_of_range);
+
+  bit_writer writer;
+  writer.write_unary(64);
+  bitset too_long = writer.release();
+  bit_reader gamma(too_long);
+  CHECK_THROWS_AS(gamma.read_gamma(), std::invalid_argument);
+}
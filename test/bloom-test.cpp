@@ -0,0 +1,151 @@
+#include "bitset-bloom.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<uint64_t> random_hashes(std::size_t count, uint64_t seed) {
+  std::mt19937_64 gen(seed);
+  std::vector<uint64_t> result(count);
+  for (uint64_t& hash : result) {
+    hash = gen();
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("blocked bloom filter") {
+  std::size_t hashes = GENERATE(1, 4, 8);
+  CAPTURE(hashes);
+
+  std::vector<uint64_t> keys = random_hashes(2000, 1);
+  std::vector<uint64_t> others = random_hashes(20000, 2);
+
+  blocked_bloom_filter filter(20000, hashes);
+  CHECK(filter.size() % blocked_bloom_filter::BLOCK_BITS == 0);
+  CHECK(filter.size() >= 20000);
+  CHECK(filter.hashes() == hashes);
+
+  SECTION("invalid parameters") {
+    CHECK_THROWS_AS(blocked_bloom_filter(20000, 0), std::invalid_argument);
+    CHECK_THROWS_AS(blocked_bloom_filter(20000, blocked_bloom_filter::BLOCK_BITS + 1), std::invalid_argument);
+    std::size_t too_many_bits = (blocked_bloom_filter::MAX_BLOCKS + 1) * blocked_bloom_filter::BLOCK_BITS;
+    CHECK_THROWS_AS(blocked_bloom_filter(too_many_bits, hashes), std::invalid_argument);
+  }
+
+  SECTION("no false negatives") {
+    filter.insert(keys);
+    for (uint64_t key : keys) {
+      REQUIRE(filter.contains(key));
+    }
+    CHECK(filter.bits().count() <= keys.size() * hashes);
+  }
+
+  SECTION("false positive rate") {
+    filter.insert(keys);
+    std::size_t positives = 0;
+    for (uint64_t key : others) {
+      positives += filter.contains(key);
+    }
+    CHECK(positives < others.size() / 10);
+  }
+
+  SECTION("batch lookup") {
+    for (uint64_t key : keys) {
+      filter.insert(key);
+    }
+    std::vector<uint64_t> queries = keys;
+    queries.insert(queries.end(), others.begin(), others.begin() + 500);
+
+    auto storage = std::make_unique<bool[]>(queries.size());
+    std::span<bool> out(storage.get(), queries.size());
+    filter.contains(queries, out);
+    bitset packed(queries.size(), false);
+    filter.contains(queries, packed);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+      REQUIRE(out[i] == filter.contains(queries[i]));
+      REQUIRE(packed[i] == out[i]);
+    }
+  }
+
+  SECTION("union and intersection") {
+    blocked_bloom_filter other(20000, hashes);
+    filter.insert(std::span(keys).first(1000));
+    other.insert(std::span(keys).subspan(500));
+
+    blocked_bloom_filter united = filter;
+    united |= other;
+    for (uint64_t key : keys) {
+      REQUIRE(united.contains(key));
+    }
+
+    blocked_bloom_filter intersected = filter;
+    intersected &= other;
+    for (std::size_t i = 500; i < 1000; ++i) {
+      REQUIRE(intersected.contains(keys[i]));
+    }
+    CHECK(intersected.bits().count() <= united.bits().count());
+  }
+
+  SECTION("serialization") {
+    filter.insert(keys);
+    std::stringstream stream;
+    filter.serialize(stream);
+    blocked_bloom_filter restored = blocked_bloom_filter::deserialize(stream);
+    CHECK(restored.hashes() == filter.hashes());
+    CHECK(restored.bits() == filter.bits());
+    for (uint64_t key : keys) {
+      REQUIRE(restored.contains(key));
+    }
+  }
+
+  SECTION("corrupted serialization") {
+    filter.insert(keys);
+    std::stringstream stream;
+    filter.serialize(stream);
+    std::string encoded = stream.str();
+    for (std::size_t length : {std::size_t(0), std::size_t(15), std::size_t(16), encoded.size() - 1}) {
+      CAPTURE(length);
+      std::stringstream truncated(encoded.substr(0, length));
+      CHECK_THROWS_AS(blocked_bloom_filter::deserialize(truncated), std::invalid_argument);
+    }
+
+    auto with_header = [&encoded](uint64_t header_hashes, uint64_t header_blocks) {
+      std::string result = encoded;
+      std::memcpy(result.data(), &header_hashes, sizeof(header_hashes));
+      std::memcpy(result.data() + sizeof(header_hashes), &header_blocks, sizeof(header_blocks));
+      return std::stringstream(result);
+    };
+    uint64_t blocks = filter.blocks();
+    std::stringstream no_hashes = with_header(0, blocks);
+    CHECK_THROWS_AS(blocked_bloom_filter::deserialize(no_hashes), std::invalid_argument);
+    std::stringstream too_many_hashes = with_header(blocked_bloom_filter::BLOCK_BITS + 1, blocks);
+    CHECK_THROWS_AS(blocked_bloom_filter::deserialize(too_many_hashes), std::invalid_argument);
+    std::stringstream no_blocks = with_header(filter.hashes(), 0);
+    CHECK_THROWS_AS(blocked_bloom_filter::deserialize(no_blocks), std::invalid_argument);
+    std::stringstream overflowing = with_header(filter.hashes(), uint64_t(1) << 58);
+    CHECK_THROWS_AS(blocked_bloom_filter::deserialize(overflowing), std::invalid_argument);
+    std::stringstream more_blocks = with_header(filter.hashes(), blocks + 1);
+    CHECK_THROWS_AS(blocked_bloom_filter::deserialize(more_blocks), std::invalid_argument);
+    // The largest valid header is rejected once the stream runs out, without
+    // allocating the 256 GiB it claims.
+    std::stringstream max_blocks = with_header(filter.hashes(), blocked_bloom_filter::MAX_BLOCKS);
+    CHECK_THROWS_AS(blocked_bloom_filter::deserialize(max_blocks), std::invalid_argument);
+  }
+
+  SECTION("clear") {
+    filter.insert(keys);
+    filter.clear();
+    CHECK_FALSE(filter.bits().any());
+  }
+}
@@ -0,0 +1,101 @@
+#include "bitset-compress.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+
+TEST_CASE("compress and expand") {
+  SECTION("small") {
+    bitset data("1101100111");
+    bitset mask("1010101100");
+    CHECK_THAT(bitset_compress::compress(data, mask), bitset_equals_string("10101"));
+    CHECK_THAT(bitset_compress::expand(bitset("0111"), bitset("0110110")), bitset_equals_string("0010110"));
+  }
+
+  SECTION("empty mask") {
+    bitset data(100, true);
+    bitset mask(100, false);
+    CHECK(bitset_compress::compress(data, mask).empty());
+    CHECK(bitset_compress::expand(bitset(), mask) == mask);
+  }
+
+  SECTION("random views") {
+    std::mt19937 gen(7);
+    std::size_t size = GENERATE(1, 63, 64, 65, 5000);
+    double density = GENERATE(0.05, 0.5, 1.0);
+    std::size_t offset = GENERATE(0, 5);
+    CAPTURE(size, density, offset);
+
+    bitset data_storage(size + offset, false);
+    bitset mask_storage(size + 2 * offset, false);
+    bitset::view data = data_storage.subview(offset);
+    bitset::view mask = mask_storage.subview(2 * offset, size);
+    std::bernoulli_distribution bit_dist(0.5);
+    std::bernoulli_distribution mask_dist(density);
+    bitset expected_compressed(size, false);
+    std::size_t selected = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      data[i] = bit_dist(gen);
+      mask[i] = mask_dist(gen);
+      if (mask[i]) {
+        expected_compressed[selected++] = static_cast<bool>(data[i]);
+      }
+    }
+    expected_compressed >>= size - selected;
+
+    bitset compressed = bitset_compress::compress(data, mask);
+    CHECK(compressed == expected_compressed);
+
+    bitset expanded = bitset_compress::expand(compressed, mask);
+    CHECK(expanded == (data & mask));
+
+    bitset packed_storage(compressed.size() + offset, true);
+    packed_storage.subview(offset).assign(compressed);
+    CHECK(bitset_compress::expand(packed_storage.subview(offset), mask) == expanded);
+  }
+}
+
+TEST_CASE("compress and expand words") {
+  using word_type = bitset::word_type;
+  std::mt19937_64 gen(73);
+  // Bit-by-bit reference versions.
+  auto naive_compress = [](word_type data, word_type mask) {
+    word_type result = 0;
+    for (std::size_t i = 0, out = 0; i < 64; ++i) {
+      if ((mask >> i) & 1) {
+        result |= ((data >> i) & 1) << out++;
+      }
+    }
+    return result;
+  };
+  auto naive_expand = [](word_type data, word_type mask) {
+    word_type result = 0;
+    for (std::size_t i = 0, in = 0; i < 64; ++i) {
+      if ((mask >> i) & 1) {
+        result |= ((data >> in++) & 1) << i;
+      }
+    }
+    return result;
+  };
+
+  for (std::size_t iteration = 0; iteration < 2000; ++iteration) {
+    word_type data = gen();
+    // Sparse, dense and all-or-nothing masks.
+    word_type mask = iteration % 4 == 0 ? gen() & gen() & gen() : iteration % 4 == 1 ? gen() | gen() : gen();
+    if (iteration == 1) {
+      mask = 0;
+    } else if (iteration == 2) {
+      mask = ~word_type(0);
+    }
+    CAPTURE(data, mask);
+    word_type compressed = naive_compress(data, mask);
+    word_type expanded = naive_expand(data, mask);
+    REQUIRE(bitset_compress::compress_word_portable(data, mask) == compressed);
+    REQUIRE(bitset_compress::expand_word_portable(data, mask) == expanded);
+    REQUIRE(bitset_compress::compress_word(data, mask) == compressed);
+    REQUIRE(bitset_compress::expand_word(data, mask) == expanded);
+  }
+}
@@ -0,0 +1,48 @@
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string_view>
+
+namespace {
+constexpr std::size_t count_ones(std::string_view str) {
+  return bitset(str).count();
+}
+
+constexpr bool and_matches(std::string_view lhs, std::string_view rhs, std::string_view expected) {
+  bitset bs(lhs);
+  bs &= bitset(rhs);
+  return bs == bitset(expected);
+}
+
+// Builds a mask with every `step`-th bit set, at compile time.
+constexpr bitset strided_mask(std::size_t size, std::size_t step) {
+  bitset result(size, false);
+  for (std::size_t i = 0; i < size; i += step) {
+    result[i] = true;
+  }
+  return result;
+}
+
+constexpr bool view_operations() {
+  bitset bs(150, false);
+  bs.subview(3, 100).set();
+  bs.subview(60, 20).flip();
+  bitset copy = bs;
+  copy.subview(1, 140).assign(bs.subview(0, 140));
+  return bs.count() == 80 && copy.count() == 80 && copy[4] && !copy[3] && !bs.subview(60, 20).any() &&
+         bs.subview(80).all() == false;
+}
+} // namespace
+
+static_assert(count_ones("1011001") == 4);
+static_assert(count_ones("") == 0);
+static_assert(and_matches("1101", "0111", "0101"));
+static_assert(strided_mask(200, 3).count() == 67);
+static_assert(view_operations());
+
+TEST_CASE("constexpr bitset") {
+  constexpr std::size_t ones = strided_mask(1000, 7).count();
+  CHECK(ones == strided_mask(1000, 7).count());
+  CHECK(view_operations());
+}
@@ -0,0 +1,161 @@
+#include "bitset-cow.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+constexpr std::size_t CHUNK = cow_bitset::CHUNK_BITS;
+
+TEST_CASE("copy-on-write bitset") {
+  std::size_t size = 3 * CHUNK + 100;
+  bitset bits(size, false);
+  bits[5] = true;
+  bits[CHUNK + 7] = true;
+  bits[size - 1] = true;
+  cow_bitset original(bits);
+  REQUIRE(original.chunks() == 4);
+  CHECK(original.count() == 3);
+
+  SECTION("copies share until written") {
+    cow_bitset copy = original;
+    for (std::size_t i = 0; i < copy.chunks(); ++i) {
+      CHECK(copy.shared(i));
+    }
+
+    copy[2 * CHUNK + 1] = true;
+    CHECK(copy.shared(0));
+    CHECK(copy.shared(1));
+    CHECK_FALSE(copy.shared(2));
+    CHECK(copy.shared(3));
+    CHECK(copy.count() == 4);
+    CHECK(original.count() == 3);
+    CHECK_FALSE(original[2 * CHUNK + 1]);
+    CHECK(std::as_const(copy)[2 * CHUNK + 1]);
+  }
+
+  SECTION("reads do not unshare") {
+    const cow_bitset copy = original;
+    CHECK(copy[5]);
+    CHECK(copy.chunk(1).count() == 1);
+    CHECK(copy == original);
+    CHECK(copy.shared(1));
+  }
+
+  SECTION("mutable chunk") {
+    cow_bitset copy = original;
+    copy.mutable_chunk(3).flip();
+    CHECK(copy.shared(0));
+    CHECK_FALSE(copy.shared(3));
+    CHECK(copy.count() == 2 + 99);
+    CHECK(copy != original);
+  }
+
+  SECTION("references outlive copies") {
+    cow_bitset::reference bit = original[6];
+    cow_bitset::view view = original.mutable_chunk(1);
+    cow_bitset copy = original;
+    CHECK_FALSE(copy.shared(0));
+    CHECK_FALSE(copy.shared(1));
+    CHECK(copy.shared(2));
+
+    bit = true;
+    view.flip();
+    CHECK(original[6]);
+    CHECK(original.chunk(1).count() == CHUNK - 1);
+    CHECK_FALSE(copy[6]);
+    CHECK(copy.chunk(1).count() == 1);
+
+    cow_bitset assigned;
+    assigned = original;
+    CHECK_FALSE(assigned.shared(0));
+    CHECK(assigned == original);
+
+    original.reset();
+    cow_bitset cleared = original;
+    CHECK(cleared.shared(0));
+  }
+
+  SECTION("compound operations keep untouched chunks shared") {
+    cow_bitset copy = original;
+    bitset mask(size, false);
+    mask[CHUNK + 8] = true;
+    copy |= mask;
+    CHECK(copy.shared(0));
+    CHECK_FALSE(copy.shared(1));
+    CHECK(copy.shared(2));
+    CHECK(copy.count() == 4);
+
+    bitset ones(size, true);
+    ones[5] = false;
+    copy &= ones;
+    CHECK_FALSE(copy[5]);
+    CHECK(copy.shared(2));
+    CHECK(copy.count() == 3);
+  }
+
+  SECTION("operations between copies") {
+    cow_bitset copy = original;
+    copy[CHUNK] = true;
+    cow_bitset diff = original;
+    diff ^= copy;
+    CHECK(diff.count() == 1);
+    CHECK(diff[CHUNK]);
+
+    cow_bitset both = original;
+    both |= copy;
+    CHECK(both == copy);
+    CHECK(both.shared(0));
+  }
+
+  SECTION("materialize") {
+    bitset plain = original.to_bitset();
+    CHECK(plain.size() == size);
+    CHECK(plain.count() == 3);
+    CHECK(plain[CHUNK + 7]);
+    CHECK(cow_bitset(plain) == original);
+
+    original.set();
+    CHECK(original.all());
+    original.reset();
+    CHECK_FALSE(original.any());
+  }
+}
+
+// Meant to be run under ThreadSanitizer: readers finish with their copies and
+// drop them while the owner keeps writing to the chunks they shared.
+TEST_CASE("copy-on-write bitset across threads") {
+  constexpr std::size_t READERS = 4;
+  constexpr std::size_t ROUNDS = 20;
+  std::size_t size = 2 * CHUNK + 10;
+
+  for (std::size_t round = 0; round < ROUNDS; ++round) {
+    bitset bits(size, false);
+    bits[round] = true;
+    bits[CHUNK + round] = true;
+    cow_bitset owner(bits);
+
+    std::vector<std::size_t> counts(READERS);
+    {
+      std::vector<std::jthread> readers;
+      for (std::size_t r = 0; r < READERS; ++r) {
+        readers.emplace_back([&counts, r, copy = owner]() mutable {
+          counts[r] = copy.count();
+          cow_bitset dropped = std::move(copy);
+        });
+      }
+      for (std::size_t i = 0; i < size; i += 97) {
+        owner[i] = !owner[i];
+      }
+    }
+
+    for (std::size_t r = 0; r < READERS; ++r) {
+      CHECK(counts[r] == 2);
+    }
+    CHECK_FALSE(owner.shared(0));
+    CHECK_FALSE(owner.shared(1));
+  }
+}
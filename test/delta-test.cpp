@@ -0,0 +1,110 @@
+#include "bitset-delta.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+#include <stdexcept>
+
+TEST_CASE("delta diff and patch") {
+  SECTION("identical") {
+    bitset bs(1000, true);
+    bitset_delta::delta d = bitset_delta::diff(bs, bs);
+    CHECK(d.size == 1000);
+    CHECK(d.encoded.empty());
+  }
+
+  SECTION("few changes are compact") {
+    bitset before(1'000'000, false);
+    bitset after = before;
+    after[17] = true;
+    after[500'000] = true;
+    after[999'999] = true;
+    bitset_delta::delta d = bitset_delta::diff(before, after);
+    CHECK(d.encoded.size() < 20);
+
+    bitset_delta::apply_patch(before, d);
+    CHECK(before == after);
+  }
+
+  SECTION("flipped range is run-length encoded") {
+    bitset before(100'000, false);
+    bitset after = before;
+    after.subview(1000, 90'000).flip();
+    bitset_delta::delta d = bitset_delta::diff(before, after);
+    CHECK(d.encoded.size() < 40);
+
+    bitset_delta::apply_patch(before, d);
+    CHECK(before == after);
+  }
+
+  SECTION("random views") {
+    std::mt19937 gen(3);
+    std::size_t size = GENERATE(1, 64, 130, 20'000);
+    std::size_t offset = GENERATE(0, 9);
+    double density = GENERATE(0.0005, 0.05, 0.5);
+    CAPTURE(size, offset, density);
+
+    bitset before(size + offset, false);
+    std::bernoulli_distribution bit_dist(0.5);
+    for (std::size_t i = 0; i < before.size(); ++i) {
+      before[i] = bit_dist(gen);
+    }
+    bitset after = before;
+    std::bernoulli_distribution change_dist(density);
+    for (std::size_t i = offset; i < after.size(); ++i) {
+      if (change_dist(gen)) {
+        after[i].flip();
+      }
+    }
+    if (size >= 1000) {
+      after.subview(offset + 300, 500).flip();
+    }
+
+    bitset_delta::delta d = bitset_delta::diff(before.subview(offset), after.subview(offset));
+    bitset target = before;
+    bitset_delta::apply_patch(target.subview(offset), d);
+    CHECK(target == after);
+
+    bitset_delta::apply_patch(target.subview(offset), d);
+    CHECK(target == before);
+  }
+
+  SECTION("malformed") {
+    bitset bs(100, false);
+    bitset_delta::delta d = bitset_delta::diff(bs, ~bs);
+    CHECK_THROWS_AS(bitset_delta::apply_patch(bitset(101, false), d), std::invalid_argument);
+
+    bitset_delta::delta truncated = d;
+    truncated.encoded.pop_back();
+    CHECK_THROWS_AS(bitset_delta::apply_patch(bs, truncated), std::invalid_argument);
+
+    bitset_delta::delta past_end{100, {8 << 2, 0}};
+    CHECK_THROWS_AS(bitset_delta::apply_patch(bs, past_end), std::invalid_argument);
+  }
+
+  SECTION("rejected patch leaves the target unchanged") {
+    bitset before(300, false);
+    bitset after = before;
+    after[3] = true;
+    after.subview(64, 128).flip();
+    bitset_delta::delta d = bitset_delta::diff(before, after);
+    bitset target = before;
+
+    bitset_delta::delta truncated = d;
+    truncated.encoded.pop_back();
+    CHECK_THROWS_AS(bitset_delta::apply_patch(target, truncated), std::invalid_argument);
+    CHECK(target == before);
+
+    // Valid chunks followed by one that flips a bit past the end of the target.
+    bitset_delta::delta past_end = d;
+    past_end.encoded.insert(past_end.encoded.end(), {1 << 2, 1, 50});
+    CHECK_THROWS_AS(bitset_delta::apply_patch(target, past_end), std::invalid_argument);
+    CHECK(target == before);
+
+    bitset_delta::apply_patch(target, d);
+    CHECK(target == after);
+  }
+}
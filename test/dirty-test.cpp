@@ -0,0 +1,58 @@
+#include "bitset-dirty.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#ifdef BITSET_ENABLE_DIRTY_TRACKING
+using bitset_dirty::BLOCK_BITS;
+using bitset_dirty::range;
+
+TEST_CASE("dirty tracking") {
+  std::size_t size = 10 * BLOCK_BITS + 100;
+  bitset bs(size, false);
+  CHECK(bs.dirty_ranges() == std::vector<range>{{0, size}});
+  bs.clear_dirty();
+  CHECK_FALSE(bs.dirty());
+  CHECK(bs.dirty_ranges().empty());
+
+  SECTION("reference") {
+    bs[3 * BLOCK_BITS + 5] = true;
+    bs[size - 1].flip();
+    CHECK(bs.dirty_ranges() == std::vector<range>{{3 * BLOCK_BITS, BLOCK_BITS}, {10 * BLOCK_BITS, 100}});
+  }
+
+  SECTION("view operations") {
+    bs.subview(BLOCK_BITS - 10, 20).flip();
+    bs.subview(5 * BLOCK_BITS + 1, 2 * BLOCK_BITS) |= bs.subview(0, 2 * BLOCK_BITS);
+    CHECK(bs.dirty_ranges() == std::vector<range>{{0, 2 * BLOCK_BITS}, {5 * BLOCK_BITS, 3 * BLOCK_BITS}});
+  }
+
+  SECTION("aligned assign") {
+    bs.subview(2 * BLOCK_BITS + 7, 3 * BLOCK_BITS).assign(bs.subview(7, 3 * BLOCK_BITS));
+    CHECK(bs.dirty_ranges() == std::vector<range>{{2 * BLOCK_BITS, 4 * BLOCK_BITS}});
+  }
+
+  SECTION("indices") {
+    std::array<uint32_t, 3> indices = {1, 2, static_cast<uint32_t>(9 * BLOCK_BITS)};
+    bs.set_indices(indices);
+    CHECK(bs.dirty_ranges() == std::vector<range>{{0, BLOCK_BITS}, {9 * BLOCK_BITS, BLOCK_BITS}});
+  }
+
+  SECTION("reads") {
+    bool any = bs.any();
+    std::size_t count = bs.subview(17).count();
+    bool bit = bs[BLOCK_BITS];
+    CHECK_FALSE((any || count != 0 || bit));
+    CHECK_FALSE(bs.dirty());
+  }
+
+  SECTION("assignment") {
+    bs = bitset(size, true);
+    CHECK(bs.dirty_ranges() == std::vector<range>{{0, size}});
+  }
+}
+#endif
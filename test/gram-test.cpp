@@ -0,0 +1,52 @@
+#include "bitset-gram.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+#include <vector>
+
+TEST_CASE("intersection count matrix") {
+  std::mt19937 gen(17);
+  std::size_t size = GENERATE(0, 1, 100, 40'000);
+  std::size_t threads = GENERATE(1, 3);
+  CAPTURE(size, threads);
+
+  std::bernoulli_distribution dist(0.3);
+  std::vector<bitset> storage;
+  for (std::size_t i = 0; i < 20; ++i) {
+    storage.emplace_back(size + i % 3, false);
+    for (std::size_t j = 0; j < storage.back().size(); ++j) {
+      storage.back()[j] = dist(gen);
+    }
+  }
+  std::vector<bitset::const_view> lhs;
+  std::vector<bitset::const_view> rhs;
+  for (std::size_t i = 0; i < storage.size(); ++i) {
+    bitset::const_view view = storage[i].subview(i % 3);
+    (i < 11 ? lhs : rhs).push_back(view);
+  }
+
+  std::vector<std::size_t> counts = bitset_gram::intersection_counts(lhs, rhs, threads);
+  REQUIRE(counts.size() == lhs.size() * rhs.size());
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    for (std::size_t j = 0; j < rhs.size(); ++j) {
+      CAPTURE(i, j);
+      REQUIRE(counts[i * rhs.size() + j] == and_count(lhs[i], rhs[j]));
+    }
+  }
+
+  std::vector<std::size_t> symmetric = bitset_gram::intersection_counts(lhs, lhs, threads);
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    REQUIRE(symmetric[i * lhs.size() + i] == lhs[i].count());
+  }
+}
+
+TEST_CASE("intersection count matrix of empty collections") {
+  std::vector<bitset::const_view> none;
+  bitset bs(10, true);
+  std::vector<bitset::const_view> one = {bs};
+  CHECK(bitset_gram::intersection_counts(none, one, 4).empty());
+  CHECK(bitset_gram::intersection_counts(one, none).empty());
+}
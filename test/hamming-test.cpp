@@ -0,0 +1,87 @@
+#include "bitset-hamming.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST_CASE("hamming index") {
+  std::mt19937 gen(13);
+  std::size_t bits = GENERATE(1, 256, 1000);
+  CAPTURE(bits);
+
+  std::vector<bitset> signatures;
+  hamming_index index(bits);
+  for (std::size_t i = 0; i < 300; ++i) {
+    signatures.push_back(random_bitset(bits, gen));
+    CHECK(index.add(signatures.back()) == i);
+  }
+  REQUIRE(index.size() == signatures.size());
+  CHECK(index.signature(17) == signatures[17]);
+
+  bitset storage = random_bitset(bits + 5, gen);
+  bitset::const_view query = storage.subview(5);
+  std::vector<hamming_index::match> expected;
+  for (std::size_t i = 0; i < signatures.size(); ++i) {
+    expected.push_back({i, (query ^ signatures[i]).count()});
+  }
+
+  SECTION("distances") {
+    std::vector<std::size_t> out(index.size());
+    index.distances(query, out);
+    for (std::size_t i = 0; i < out.size(); ++i) {
+      REQUIRE(out[i] == expected[i].distance);
+    }
+    CHECK(index.distance(query, 42) == expected[42].distance);
+
+    std::vector<uint32_t> candidates = {299, 3, 150};
+    std::vector<std::size_t> subset(candidates.size());
+    index.distances(query, candidates, subset);
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+      CHECK(subset[i] == expected[candidates[i]].distance);
+    }
+  }
+
+  std::ranges::sort(expected, [](const hamming_index::match& lhs, const hamming_index::match& rhs) {
+    return lhs.distance != rhs.distance ? lhs.distance < rhs.distance : lhs.index < rhs.index;
+  });
+
+  SECTION("top k") {
+    std::size_t k = GENERATE(1, 10, 500);
+    CAPTURE(k);
+    std::vector<hamming_index::match> top = index.top_k(query, k);
+    std::vector<hamming_index::match> want(expected.begin(), expected.begin() + std::min(k, expected.size()));
+    CHECK(top == want);
+  }
+
+  SECTION("top k with threshold") {
+    std::size_t threshold = expected[5].distance;
+    std::vector<hamming_index::match> top = index.top_k(query, 100, threshold);
+    std::vector<hamming_index::match> want;
+    for (const hamming_index::match& m : expected) {
+      if (m.distance <= threshold && want.size() < 100) {
+        want.push_back(m);
+      }
+    }
+    CHECK(top == want);
+  }
+
+  SECTION("top k of candidates") {
+    std::vector<uint32_t> candidates;
+    for (uint32_t i = 300; i >= 3; i -= 3) {
+      candidates.push_back(i - 1);
+    }
+    std::vector<hamming_index::match> want;
+    for (const hamming_index::match& m : expected) {
+      if (m.index % 3 == 299 % 3 && want.size() < 7) {
+        want.push_back(m);
+      }
+    }
+    CHECK(index.top_k(query, candidates, 7) == want);
+  }
+}
@@ -0,0 +1,116 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+TEST_CASE("set/reset/flip by indices") {
+  SECTION("sorted") {
+    std::vector<uint32_t> indices = {0, 3, 4, 63, 64, 65, 127, 130};
+    bitset bs(131, false);
+
+    bs.set_indices(indices);
+    for (std::size_t i = 0; i < bs.size(); ++i) {
+      CAPTURE(i);
+      REQUIRE(bs[i] == (std::ranges::find(indices, i) != indices.end()));
+    }
+    CHECK(bs.count() == indices.size());
+
+    bs.reset_indices(std::span(indices).first(4));
+    CHECK(bs.count() == indices.size() - 4);
+
+    bs.flip_indices(indices);
+    CHECK(bs.count() == 4);
+    CHECK(bs[0]);
+    CHECK(bs[63]);
+    CHECK_FALSE(bs[64]);
+  }
+
+  SECTION("unsorted with duplicates") {
+    std::vector<uint64_t> indices = {70, 2, 70, 5, 2, 2, 129};
+    bitset bs(130, false);
+
+    bs.set_indices(indices);
+    CHECK(bs.count() == 4);
+
+    bs.reset();
+    bs.flip_indices(indices);
+    CHECK(bs[2] == true);
+    CHECK(bs[5] == true);
+    CHECK(bs[70] == false);
+    CHECK(bs[129] == true);
+    CHECK(bs.count() == 3);
+  }
+
+  SECTION("unaligned view") {
+    bitset bs(200, false);
+    std::array<uint32_t, 4> indices = {0, 1, 60, 100};
+    std::size_t offset = GENERATE(0, 1, 37, 64, 99);
+    CAPTURE(offset);
+
+    bs.subview(offset, 101).set_indices(indices);
+    CHECK(bs.count() == indices.size());
+    for (uint32_t index : indices) {
+      CHECK(bs[offset + index]);
+    }
+
+    bs.subview(offset, 101).reset_indices(indices);
+    CHECK_FALSE(bs.any());
+  }
+
+  SECTION("empty list") {
+    bitset bs("1011");
+    bs.set_indices(std::span<const uint32_t>());
+    bs.flip_indices(std::span<const uint64_t>());
+    CHECK_THAT(bs, bitset_equals_string("1011"));
+  }
+}
+
+TEST_CASE("test by indices") {
+  std::string str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101";
+  const bitset bs(str);
+
+  std::vector<uint32_t> indices;
+  for (uint32_t i = 0; i < str.size(); i += 3) {
+    indices.push_back(i);
+  }
+  indices.push_back(1);
+  indices.push_back(79);
+
+  SECTION("booleans") {
+    auto storage = std::make_unique<bool[]>(indices.size());
+    std::span<bool> out(storage.get(), indices.size());
+    bs.test_indices(indices, out);
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+      CAPTURE(i);
+      REQUIRE(out[i] == (str[indices[i]] == '1'));
+    }
+  }
+
+  SECTION("packed") {
+    bitset out(indices.size(), true);
+    bs.test_indices(indices, out);
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+      CAPTURE(i);
+      REQUIRE(out[i] == (str[indices[i]] == '1'));
+    }
+  }
+
+  SECTION("unaligned view") {
+    std::size_t offset = GENERATE(1, 17);
+    CAPTURE(offset);
+    std::vector<uint64_t> shifted = {0, 5, 40, 62};
+    std::array<bool, 4> out{};
+    bs.subview(offset).test_indices(shifted, out);
+    for (std::size_t i = 0; i < shifted.size(); ++i) {
+      CHECK(out[i] == (str[offset + shifted[i]] == '1'));
+    }
+  }
+}
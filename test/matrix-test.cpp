@@ -0,0 +1,120 @@
+#include "bitset-matrix.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+bit_matrix random_matrix(std::size_t rows, std::size_t cols, std::mt19937& gen) {
+  bit_matrix result(rows, cols, false);
+  std::bernoulli_distribution dist(0.3);
+  for (std::size_t i = 0; i < rows; ++i) {
+    for (std::size_t j = 0; j < cols; ++j) {
+      result(i, j) = dist(gen);
+    }
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("bit_matrix construction") {
+  SECTION("filled") {
+    bool value = GENERATE(false, true);
+    bit_matrix m(3, 70, value);
+    CHECK(m.rows() == 3);
+    CHECK(m.cols() == 70);
+    for (std::size_t i = 0; i < m.rows(); ++i) {
+      CHECK(m.row(i).size() == 70);
+      CHECK(m.row(i).count() == (value ? 70 : 0));
+    }
+  }
+
+  SECTION("from rows") {
+    std::vector<bitset> rows = {bitset("10110"), bitset("01100"), bitset("00001")};
+    bit_matrix m(rows);
+    CHECK(m.rows() == 3);
+    CHECK(m.cols() == 5);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+      CHECK(m.row(i) == rows[i]);
+    }
+    CHECK(m(0, 2));
+    CHECK_FALSE(m(1, 0));
+
+    rows.push_back(bitset("0110"));
+    CHECK_THROWS_AS(bit_matrix(rows), std::invalid_argument);
+  }
+
+  SECTION("rows are views") {
+    bit_matrix m(2, 100, false);
+    m.row(1).subview(10, 20).set();
+    CHECK(m.row(0).count() == 0);
+    CHECK(m.row(1).count() == 20);
+    CHECK(m(1, 10));
+    CHECK_FALSE(m(1, 30));
+  }
+}
+
+TEST_CASE("bit_matrix transpose") {
+  std::mt19937 gen(42);
+  auto [rows, cols] = GENERATE(
+      std::pair<std::size_t, std::size_t>(0, 0),
+      std::pair<std::size_t, std::size_t>(1, 1),
+      std::pair<std::size_t, std::size_t>(3, 70),
+      std::pair<std::size_t, std::size_t>(64, 64),
+      std::pair<std::size_t, std::size_t>(130, 65),
+      std::pair<std::size_t, std::size_t>(600, 517)
+  );
+  CAPTURE(rows, cols);
+
+  bit_matrix m = random_matrix(rows, cols, gen);
+  bit_matrix t = m.transposed();
+
+  REQUIRE(t.rows() == cols);
+  REQUIRE(t.cols() == rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    for (std::size_t j = 0; j < cols; ++j) {
+      REQUIRE(t(j, i) == m(i, j));
+    }
+  }
+  CHECK(t.transposed() == m);
+}
+
+TEST_CASE("bit_matrix reductions") {
+  std::mt19937 gen(7);
+  bit_matrix m = random_matrix(90, 150, gen);
+  m.row(5).set();
+  for (std::size_t i = 0; i < m.rows(); ++i) {
+    m(i, 149) = true;
+  }
+
+  std::vector<std::size_t> row_counts = m.row_counts();
+  std::vector<std::size_t> column_counts = m.column_counts();
+  bit_matrix t = m.transposed();
+  for (std::size_t i = 0; i < m.rows(); ++i) {
+    CHECK(row_counts[i] == m.row(i).count());
+  }
+  for (std::size_t j = 0; j < m.cols(); ++j) {
+    CHECK(column_counts[j] == t.row(j).count());
+  }
+
+  bitset any_row = m.or_rows();
+  bitset all_rows = m.and_rows();
+  for (std::size_t j = 0; j < m.cols(); ++j) {
+    CHECK(any_row[j] == t.row(j).any());
+    CHECK(all_rows[j] == t.row(j).all());
+  }
+  CHECK(all_rows[149]);
+
+  bitset any_column = m.or_columns();
+  bitset all_columns = m.and_columns();
+  for (std::size_t i = 0; i < m.rows(); ++i) {
+    CHECK(any_column[i] == m.row(i).any());
+    CHECK(all_columns[i] == m.row(i).all());
+  }
+  CHECK(all_columns[5]);
+}
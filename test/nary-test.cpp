@@ -0,0 +1,75 @@
+#include "bitset-nary.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+std::vector<bitset> random_bitsets(std::size_t count, std::size_t size, std::mt19937& gen) {
+  std::vector<bitset> result;
+  std::bernoulli_distribution dist(0.6);
+  for (std::size_t i = 0; i < count; ++i) {
+    bitset bs(size, false);
+    for (std::size_t j = 0; j < size; ++j) {
+      bs[j] = dist(gen);
+    }
+    result.push_back(bs);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("n-ary operations") {
+  std::mt19937 gen(1);
+  std::size_t count = GENERATE(1, 2, 7, 17);
+  std::size_t size = GENERATE(0, 1, 70, 33'000);
+  std::size_t offset = GENERATE(0, 5);
+  CAPTURE(count, size, offset);
+
+  std::vector<bitset> bitsets = random_bitsets(count, size + offset, gen);
+  std::vector<bitset::const_view> views;
+  for (const bitset& bs : bitsets) {
+    views.push_back(bs.subview(offset));
+  }
+
+  SECTION("and/or/xor") {
+    bitset expected_and(views[0]);
+    bitset expected_or(views[0]);
+    bitset expected_xor(views[0]);
+    for (std::size_t i = 1; i < count; ++i) {
+      expected_and &= views[i];
+      expected_or |= views[i];
+      expected_xor ^= views[i];
+    }
+    CHECK(bitset_nary::and_all(views) == expected_and);
+    CHECK(bitset_nary::or_all(views) == expected_or);
+    CHECK(bitset_nary::xor_all(views) == expected_xor);
+  }
+
+  SECTION("threshold") {
+    std::vector<std::size_t> hits(size);
+    for (const bitset::const_view& view : views) {
+      for (std::size_t j = 0; j < size; ++j) {
+        hits[j] += view[j];
+      }
+    }
+    for (std::size_t k = 0; k <= count + 1; ++k) {
+      CAPTURE(k);
+      bitset expected(size, false);
+      for (std::size_t j = 0; j < size; ++j) {
+        expected[j] = (hits[j] >= k);
+      }
+      CHECK(bitset_nary::at_least(views, k) == expected);
+      CHECK(bitset_nary::count_at_least(views, k) == expected.count());
+    }
+  }
+}
+
+TEST_CASE("n-ary operations on no views") {
+  CHECK(bitset_nary::and_all({}).empty());
+  CHECK(bitset_nary::at_least({}, 1).empty());
+  CHECK(bitset_nary::count_at_least({}, 0) == 0);
+}
@@ -0,0 +1,113 @@
+#include "bitset-numa.h"
+#include "bitset-storage.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+constexpr std::size_t SEGMENT_BITS = bitset_numa::SEGMENT_ALIGN_WORDS * bitset_common::WORD_BITS;
+} // namespace
+
+TEST_CASE("numa topology") {
+  std::vector<bitset_numa::node> nodes = bitset_numa::topology();
+  REQUIRE_FALSE(nodes.empty());
+  for (std::size_t i = 1; i < nodes.size(); ++i) {
+    CHECK(nodes[i - 1].id < nodes[i].id);
+  }
+}
+
+// Copies would lose the per-node placement.
+static_assert(!std::is_copy_constructible_v<numa_bitset>);
+static_assert(!std::is_copy_assignable_v<numa_bitset>);
+static_assert(std::is_nothrow_move_constructible_v<numa_bitset>);
+
+TEST_CASE("numa partitioned bitset") {
+  std::size_t node_count = GENERATE(1, 3);
+  std::size_t size = GENERATE(0, 1000, 3 * SEGMENT_BITS + 77, 9 * SEGMENT_BITS);
+  // Nodes with several CPUs split their segment among that many workers.
+  std::size_t cpus_per_node = GENERATE(0, 3);
+  CAPTURE(node_count, size, cpus_per_node);
+
+  std::vector<int> machine_cpus = bitset_numa::topology().front().cpus;
+  std::vector<bitset_numa::node> nodes;
+  for (std::size_t i = 0; i < node_count; ++i) {
+    nodes.push_back({static_cast<int>(i), {}});
+    for (std::size_t j = 0; j < std::min(cpus_per_node, machine_cpus.size()); ++j) {
+      nodes.back().cpus.push_back(machine_cpus[j]);
+    }
+  }
+  numa_bitset bs(size, false, nodes);
+  REQUIRE(bs.size() == size);
+  REQUIRE(bs.segments() == node_count);
+  std::size_t covered = 0;
+  for (std::size_t i = 0; i < bs.segments(); ++i) {
+    CHECK(bs.segment_node(i).id == static_cast<int>(i));
+    covered += bs.segment(i).size();
+  }
+  CHECK(covered == size);
+  CHECK_FALSE(bs.any());
+
+  std::mt19937 gen(23);
+  std::bernoulli_distribution dist(0.01);
+  bitset reference(size, false);
+  for (std::size_t i = 0; i < size; ++i) {
+    if (dist(gen)) {
+      reference[i] = true;
+      bs[i] = true;
+    }
+  }
+  CHECK(bs.count() == reference.count());
+  CHECK(bs.equals(reference));
+  CHECK(bitset::const_view(bs) == reference);
+
+  std::vector<uint64_t> expected;
+  for (std::size_t i = 0; i < size; ++i) {
+    if (reference[i]) {
+      expected.push_back(i);
+    }
+  }
+  CHECK(bs.ones() == expected);
+
+  bitset mask(size, false);
+  for (std::size_t i = 0; i < size; i += 3) {
+    mask[i] = true;
+  }
+  bs &= mask;
+  reference &= mask;
+  CHECK(bs.equals(reference));
+  bs |= mask;
+  CHECK(bs.equals(mask));
+  bs ^= mask;
+  CHECK_FALSE(bs.any());
+  bs.flip();
+  CHECK(bs.count() == size);
+
+  numa_bitset other(size, true, nodes);
+  CHECK(bs == other);
+  other.reset();
+  CHECK((size == 0 || bs != other));
+}
+
+TEST_CASE("numa segments of mapped storage") {
+  constexpr std::size_t HUGE_PAGE_BITS = bitset_numa::MAPPED_SEGMENT_ALIGN_WORDS * bitset_common::WORD_BITS;
+  std::size_t size = 5 * HUGE_PAGE_BITS + 100;
+  std::size_t words = (size + bitset_common::WORD_BITS - 1) / bitset_common::WORD_BITS;
+  std::vector<bitset_numa::node> nodes = {{0, {}}, {1, {}}, {2, {}}};
+  numa_bitset bs(size, true, nodes);
+  REQUIRE(bs.segments() == 3);
+  std::size_t align = bitset_storage::mapped(words) ? HUGE_PAGE_BITS : SEGMENT_BITS;
+  std::size_t covered = 0;
+  for (std::size_t i = 0; i < bs.segments(); ++i) {
+    CAPTURE(i);
+    CHECK(covered % align == 0);
+    covered += bs.segment(i).size();
+  }
+  CHECK(covered == size);
+  CHECK(bs.count() == size);
+}
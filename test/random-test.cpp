@@ -0,0 +1,291 @@
+#include "bitset-random.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+std::vector<std::size_t> set_positions(const bitset::const_view& bs) {
+  std::vector<std::size_t> result;
+  for (std::size_t i = 0; i < bs.size(); ++i) {
+    if (bs[i]) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+// 64-bit engine that counts its draws.
+struct counting_engine {
+  using result_type = std::mt19937_64::result_type;
+
+  static constexpr result_type min() {
+    return std::mt19937_64::min();
+  }
+
+  static constexpr result_type max() {
+    return std::mt19937_64::max();
+  }
+
+  result_type operator()() {
+    ++draws;
+    return engine();
+  }
+
+  std::mt19937_64 engine;
+  std::size_t draws = 0;
+};
+
+// 64-bit engine that returns the given words in turn.
+struct scripted_engine {
+  using result_type = bitset::word_type;
+
+  static constexpr result_type min() {
+    return 0;
+  }
+
+  static constexpr result_type max() {
+    return bitset_common::ALL_BITS;
+  }
+
+  result_type operator()() {
+    return words.at(next++);
+  }
+
+  std::vector<result_type> words;
+  std::size_t next = 0;
+};
+} // namespace
+
+TEST_CASE("random fill") {
+  std::mt19937_64 gen(41);
+  double p = GENERATE(0.0, 0.001, 0.02, 0.25, 0.3, 0.5, 0.9, 0.995, 1.0);
+  CAPTURE(p);
+
+  std::size_t size = 200000;
+  bitset storage(size + 10, false);
+  storage.subview(0, 3).set();
+  bitset::view target = storage.subview(3, size);
+  bitset_random::fill_random(target, p, gen);
+
+  double sigma = std::sqrt(size * p * (1 - p));
+  double count = static_cast<double>(target.count());
+  CHECK(std::abs(count - size * p) <= 6 * sigma + 1);
+  CHECK(storage.subview(0, 3).all());
+  CHECK_FALSE(storage.subview(size + 3).any());
+
+  // Neighbouring bits are independent: pairs of ones are as frequent as p^2.
+  std::size_t pairs = 0;
+  for (std::size_t i = 0; i + 1 < size; i += 2) {
+    pairs += target[i] && target[i + 1];
+  }
+  double expected_pairs = size / 2 * p * p;
+  CHECK(std::abs(pairs - expected_pairs) <= 6 * std::sqrt(expected_pairs) + 1);
+}
+
+TEST_CASE("random fill draws") {
+  std::size_t words = 1000;
+  bitset bs(words * bitset_common::WORD_BITS, false);
+  counting_engine rng;
+
+  // 0.5 and 0.25 have one and two binary digits.
+  bitset_random::fill_random(bs, 0.5, rng);
+  CHECK(rng.draws == words);
+  rng.draws = 0;
+  bitset_random::fill_random(bs, 0.25, rng);
+  CHECK(rng.draws == 2 * words);
+
+  // Other densities stop once every bit of a word is decided, after about 7
+  // draws per word.
+  double p = GENERATE(0.1, 0.3, 1.0 / 3, 0.7, 0.9);
+  CAPTURE(p);
+  rng.draws = 0;
+  bitset_random::fill_random(bs, p, rng);
+  CHECK(rng.draws <= 9 * words);
+
+  double sigma = std::sqrt(bs.size() * p * (1 - p));
+  CHECK(std::abs(static_cast<double>(bs.count()) - bs.size() * p) <= 6 * sigma + 1);
+}
+
+TEST_CASE("random fill is exact") {
+  // 0.01 followed by 17 zeros and a one: the last digit still decides bits
+  // whose draws matched all earlier ones.
+  double p = 0.25 + std::ldexp(1.0, -20);
+  bitset bs(bitset_common::WORD_BITS, false);
+  scripted_engine rng;
+  for (std::size_t digit = 1; digit < 20; ++digit) {
+    rng.words.push_back(digit == 2 ? bitset_common::ALL_BITS : 0);
+  }
+
+  SECTION("below p") {
+    rng.words.push_back(0);
+    bitset_random::fill_random(bs, p, rng);
+    CHECK(bs.all());
+  }
+
+  SECTION("above p") {
+    rng.words.push_back(bitset_common::ALL_BITS);
+    bitset_random::fill_random(bs, p, rng);
+    CHECK_FALSE(bs.any());
+  }
+
+  SECTION("decided early") {
+    // Above p in the first digit for the low byte, below it in the second for
+    // the rest.
+    rng.words = {0xff, 0};
+    bitset_random::fill_random(bs, p, rng);
+    CHECK(bs.count() == bitset_common::WORD_BITS - 8);
+    CHECK_FALSE(bs.subview(0, 8).any());
+    CHECK(rng.next == 2);
+  }
+}
+
+TEST_CASE("random select") {
+  std::mt19937_64 gen(43);
+  bitset storage(3000, false);
+  bitset_random::fill_random(storage, 0.3, gen);
+  bitset::const_view bs = storage.subview(7);
+  std::vector<std::size_t> positions = set_positions(bs);
+
+  for (std::size_t rank = 0; rank < positions.size(); ++rank) {
+    REQUIRE(bitset_random::select(bs, rank) == positions[rank]);
+  }
+  CHECK(bitset_random::select(bs, positions.size()) == bitset_random::npos);
+
+  std::vector<std::size_t> ranks = {0, 1, 2, 100, 101, positions.size() - 1};
+  std::vector<std::size_t> out(ranks.size());
+  bitset_random::select(bs, ranks, out);
+  for (std::size_t i = 0; i < ranks.size(); ++i) {
+    CHECK(out[i] == positions[ranks[i]]);
+  }
+}
+
+TEST_CASE("sample set bit") {
+  std::mt19937_64 gen(47);
+  CHECK(bitset_random::sample_set_bit(bitset(), gen) == bitset_random::npos);
+  CHECK(bitset_random::sample_set_bit(bitset(100, false), gen) == bitset_random::npos);
+
+  std::size_t size = GENERATE(16, 10000);
+  CAPTURE(size);
+  bitset bs(size, false);
+  std::vector<std::size_t> positions = {0, 3, 7, 15};
+  for (std::size_t i : positions) {
+    bs[i] = true;
+  }
+
+  std::vector<std::size_t> hits(size);
+  std::size_t samples = 40000;
+  for (std::size_t i = 0; i < samples; ++i) {
+    std::size_t pos = bitset_random::sample_set_bit(bs, gen);
+    REQUIRE(pos < size);
+    REQUIRE(bs[pos]);
+    ++hits[pos];
+  }
+  for (std::size_t i : positions) {
+    CHECK(hits[i] > samples / 4 - 600);
+    CHECK(hits[i] < samples / 4 + 600);
+  }
+}
+
+TEST_CASE("sample k") {
+  std::mt19937_64 gen(53);
+  bitset storage(5000, false);
+  bitset_random::fill_random(storage, 0.1, gen);
+  bitset::const_view bs = storage.subview(1);
+  std::vector<std::size_t> positions = set_positions(bs);
+
+  std::size_t k = GENERATE(0, 1, 50, 400);
+  CAPTURE(k);
+  std::vector<std::size_t> sample = bitset_random::sample_k(bs, k, gen);
+  REQUIRE(sample.size() == std::min(k, positions.size()));
+  CHECK(std::ranges::is_sorted(sample));
+  CHECK(std::ranges::adjacent_find(sample) == sample.end());
+  for (std::size_t pos : sample) {
+    REQUIRE(bs[pos]);
+  }
+
+  CHECK(bitset_random::sample_k(bs, positions.size() + 10, gen) == positions);
+
+  // Every set bit of a small view is picked about k / count of the time.
+  bitset small(10, false);
+  small.subview(2, 6).set();
+  std::vector<std::size_t> hits(10);
+  for (std::size_t i = 0; i < 12000; ++i) {
+    for (std::size_t pos : bitset_random::sample_k(small, 2, gen)) {
+      ++hits[pos];
+    }
+  }
+  for (std::size_t i = 2; i < 8; ++i) {
+    CHECK(hits[i] > 3700);
+    CHECK(hits[i] < 4300);
+  }
+}
+
+TEST_CASE("set bit sampler") {
+  std::mt19937_64 gen(59);
+  CHECK(bitset_random::set_bit_sampler(bitset()).count() == 0);
+  bitset none(1000, false);
+  bitset_random::set_bit_sampler empty(none);
+  CHECK(empty.select(0) == bitset_random::npos);
+  CHECK(bitset_random::sample_set_bit(empty, gen) == bitset_random::npos);
+  CHECK(bitset_random::sample_k(empty, 5, gen).empty());
+
+  double p = GENERATE(0.001, 0.05, 0.5);
+  std::size_t size = GENERATE(100, 511, 20000);
+  CAPTURE(p, size);
+  bitset storage(size + 5, false);
+  bitset_random::fill_random(storage, p, gen);
+  bitset::const_view bs = storage.subview(5);
+  std::vector<std::size_t> positions = set_positions(bs);
+
+  bitset_random::set_bit_sampler sampler(bs);
+  REQUIRE(sampler.count() == positions.size());
+  for (std::size_t rank = 0; rank < positions.size(); ++rank) {
+    REQUIRE(sampler.select(rank) == positions[rank]);
+  }
+  CHECK(sampler.select(positions.size()) == bitset_random::npos);
+
+  for (std::size_t i = 0; i < 100; ++i) {
+    std::size_t pos = bitset_random::sample_set_bit(sampler, gen);
+    if (positions.empty()) {
+      REQUIRE(pos == bitset_random::npos);
+    } else {
+      REQUIRE(pos < bs.size());
+      REQUIRE(bs[pos]);
+    }
+  }
+
+  std::vector<std::size_t> sample = bitset_random::sample_k(sampler, 30, gen);
+  REQUIRE(sample.size() == std::min<std::size_t>(30, positions.size()));
+  CHECK(std::ranges::is_sorted(sample));
+  CHECK(std::ranges::adjacent_find(sample) == sample.end());
+  for (std::size_t pos : sample) {
+    REQUIRE(bs[pos]);
+  }
+  CHECK(bitset_random::sample_k(sampler, positions.size() + 1, gen) == positions);
+}
+
+TEST_CASE("set bit sampler is uniform") {
+  std::mt19937_64 gen(61);
+  // Set bits in different blocks, with empty blocks between them.
+  bitset bs(5000, false);
+  std::vector<std::size_t> positions = {0, 3, 600, 601, 4999};
+  for (std::size_t i : positions) {
+    bs[i] = true;
+  }
+  bitset_random::set_bit_sampler sampler(bs);
+  std::vector<std::size_t> hits(bs.size());
+  std::size_t samples = 50000;
+  for (std::size_t i = 0; i < samples; ++i) {
+    ++hits[bitset_random::sample_set_bit(sampler, gen)];
+  }
+  for (std::size_t i : positions) {
+    CHECK(hits[i] > samples / 5 - 600);
+    CHECK(hits[i] < samples / 5 + 600);
+  }
+}
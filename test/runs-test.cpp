@@ -0,0 +1,103 @@
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+// Runs of a random length between 1 and `max_run`, alternating between values.
+bitset random_runs(std::size_t size, std::size_t max_run, std::mt19937& gen) {
+  bitset result(size, false);
+  std::uniform_int_distribution<std::size_t> length(1, max_run);
+  bool value = std::bernoulli_distribution(0.5)(gen);
+  for (std::size_t i = 0; i < size; value = !value) {
+    for (std::size_t end = std::min(size, i + length(gen)); i < end; ++i) {
+      result[i] = value;
+    }
+  }
+  return result;
+}
+
+std::vector<bitset_run> naive_runs(const bitset::const_view& bs, bool value) {
+  std::vector<bitset_run> result;
+  for (std::size_t i = 0; i < bs.size(); ++i) {
+    if (bs[i] != value) {
+      continue;
+    }
+    if (i == 0 || bs[i - 1] != value) {
+      result.push_back({i, 0});
+    }
+    ++result.back().length;
+  }
+  return result;
+}
+
+std::vector<bitset_run> collect(const bitset::const_view& bs, bool value) {
+  std::vector<bitset_run> result;
+  for (const bitset_run& run : bs.runs(value)) {
+    result.push_back(run);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("runs") {
+  std::mt19937 gen(31);
+  std::size_t size = GENERATE(0, 1, 63, 64, 65, 1000, 5000);
+  std::size_t max_run = GENERATE(1, 5, 100, 700);
+  std::size_t offset = GENERATE(0, 1, 37);
+  CAPTURE(size, max_run, offset);
+
+  bitset storage = random_runs(size + offset, max_run, gen);
+  bitset::const_view bs = storage.subview(offset);
+
+  for (bool value : {true, false}) {
+    CAPTURE(value);
+    std::vector<bitset_run> expected = naive_runs(bs, value);
+    CHECK(collect(bs, value) == expected);
+    CHECK(bs.count_runs(value) == expected.size());
+
+    bitset rebuilt(bs.size(), false);
+    rebuilt.set_runs(expected);
+    if (value) {
+      CHECK(rebuilt == bs);
+    } else {
+      CHECK(rebuilt == ~bs);
+    }
+  }
+}
+
+TEST_CASE("runs edge cases") {
+  bitset ones(200, true);
+  CHECK(collect(ones, true) == std::vector<bitset_run>{{0, 200}});
+  CHECK(collect(ones, false).empty());
+  CHECK(ones.count_runs() == 1);
+  CHECK(ones.count_runs(false) == 0);
+
+  bitset zeros(200, false);
+  CHECK(zeros.runs().begin() == zeros.runs().end());
+  CHECK(zeros.count_runs(false) == 1);
+
+  // Runs crossing one word boundary, spanning a whole word and ending the range.
+  bitset bs(136, false);
+  bs.subview(1, 2).set();
+  bs.subview(64, 68).set();
+  bs[135] = true;
+  std::vector<bitset_run> expected = {{1, 2}, {64, 68}, {135, 1}};
+  CHECK(collect(bs, true) == expected);
+  CHECK(bs.count_runs() == 3);
+  CHECK(bs.subview(65, 66).count_runs() == 1);
+
+  auto it = bs.runs().begin();
+  CHECK(it->start == 1);
+  CHECK((it++)->length == 2);
+  CHECK(it->start == 64);
+
+  std::vector<bitset_run> overlapping = {{10, 5}, {12, 10}, {100, 0}, {199, 1}};
+  bitset target(200, false);
+  target.set_runs(overlapping);
+  CHECK(collect(target, true) == std::vector<bitset_run>{{10, 12}, {199, 1}});
+  CHECK(target.count() == 13);
+}
@@ -0,0 +1,72 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+
+TEST_CASE("prefix scans") {
+  SECTION("small") {
+    bitset bs("0010010000");
+    bs.prefix_or();
+    CHECK_THAT(bs, bitset_equals_string("0011111111"));
+
+    bs = "0100100110";
+    bs.prefix_xor();
+    CHECK_THAT(bs, bitset_equals_string("0111000100"));
+
+    bs = "0100100110";
+    bs.subview().fill_between();
+    CHECK_THAT(bs, bitset_equals_string("0111100110"));
+
+    bs = "0001000";
+    bs.fill_between();
+    CHECK_THAT(bs, bitset_equals_string("0001111"));
+  }
+
+  SECTION("empty") {
+    bitset bs;
+    bs.prefix_or();
+    bs.subview().prefix_xor();
+    CHECK(bs.empty());
+  }
+
+  SECTION("random views") {
+    std::mt19937 gen(11);
+    std::size_t size = GENERATE(1, 64, 65, 1000);
+    std::size_t offset = GENERATE(0, 1, 63);
+    double density = GENERATE(0.002, 0.3);
+    CAPTURE(size, offset, density);
+
+    bitset original(size + offset + 7, false);
+    std::bernoulli_distribution dist(density);
+    for (std::size_t i = 0; i < original.size(); ++i) {
+      original[i] = dist(gen);
+    }
+    bitset expected_or = original;
+    bitset expected_xor = original;
+    bitset expected_fill = original;
+    bool any = false;
+    bool parity = false;
+    for (std::size_t i = offset; i < offset + size; ++i) {
+      any = any || original[i];
+      parity = parity != original[i];
+      expected_or[i] = any;
+      expected_xor[i] = parity;
+      expected_fill[i] = parity || original[i];
+    }
+
+    bitset bs = original;
+    bs.subview(offset, size).prefix_or();
+    CHECK(bs == expected_or);
+
+    bs = original;
+    bs.subview(offset, size).prefix_xor();
+    CHECK(bs == expected_xor);
+
+    bs = original;
+    bs.subview(offset, size).fill_between();
+    CHECK(bs == expected_fill);
+  }
+}
@@ -0,0 +1,99 @@
+#include "bitset-simd.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <random>
+#include <vector>
+
+namespace {
+using block = std::array<bitset_common::word_type, bitset_common::WORD_BITS>;
+
+block random_block(std::mt19937_64& gen) {
+  block result;
+  for (auto& word : result) {
+    word = gen();
+  }
+  return result;
+}
+
+bool element(const block& b, std::size_t row, std::size_t col) {
+  return ((b[row] >> col) & 1) != 0;
+}
+} // namespace
+
+TEST_CASE("simd transpose block") {
+  std::mt19937_64 gen(61);
+  for (std::size_t iteration = 0; iteration < 100; ++iteration) {
+    block original = random_block(gen);
+    block transposed = original;
+    bitset_simd::transpose_block_scalar(transposed.data());
+    for (std::size_t i = 0; i < 64; ++i) {
+      for (std::size_t j = 0; j < 64; ++j) {
+        REQUIRE(element(transposed, j, i) == element(original, i, j));
+      }
+    }
+#ifdef __AVX2__
+    block vectorized = original;
+    bitset_simd::transpose_block_avx2(vectorized.data());
+    REQUIRE(vectorized == transposed);
+#endif
+    bitset_simd::transpose_block(transposed.data());
+    REQUIRE(transposed == original);
+  }
+}
+
+TEST_CASE("simd covers") {
+  std::mt19937_64 gen(67);
+  for (std::size_t count : {0, 1, 3, 4, 8, 11}) {
+    CAPTURE(count);
+    for (std::size_t iteration = 0; iteration < 200; ++iteration) {
+      std::vector<bitset_common::word_type> words(count);
+      std::vector<bitset_common::word_type> mask(count);
+      for (std::size_t n = 0; n < count; ++n) {
+        words[n] = gen() | gen();
+        mask[n] = words[n] & gen() & gen();
+      }
+      bool covered = true;
+      if (count != 0 && iteration % 2 == 1) {
+        std::size_t n = gen() % count;
+        bitset_common::word_type clear = ~words[n];
+        if (clear != 0) {
+          // Requires one bit that the words do not have.
+          mask[n] |= clear & (0 - clear);
+          covered = false;
+        }
+      }
+      REQUIRE(bitset_simd::covers_scalar(words.data(), mask.data(), count) == covered);
+#ifdef __AVX2__
+      REQUIRE(bitset_simd::covers_avx2(words.data(), mask.data(), count) == covered);
+#endif
+      REQUIRE(bitset_simd::covers(words.data(), mask.data(), count) == covered);
+    }
+  }
+}
+
+TEST_CASE("simd xor count") {
+  std::mt19937_64 gen(71);
+  for (std::size_t count : {0, 1, 3, 4, 5, 8, 13, 64}) {
+    CAPTURE(count);
+    for (std::size_t iteration = 0; iteration < 100; ++iteration) {
+      std::vector<bitset_common::word_type> lhs(count);
+      std::vector<bitset_common::word_type> rhs(count);
+      std::size_t expected = 0;
+      for (std::size_t n = 0; n < count; ++n) {
+        lhs[n] = gen();
+        // Every fourth row is the complement, so some words have all 64 bits differing.
+        rhs[n] = iteration % 4 == 0 ? ~lhs[n] : gen();
+        for (std::size_t bit = 0; bit < bitset_common::WORD_BITS; ++bit) {
+          expected += ((lhs[n] ^ rhs[n]) >> bit) & 1;
+        }
+      }
+      REQUIRE(bitset_simd::xor_count_scalar(lhs.data(), rhs.data(), count) == expected);
+#ifdef __AVX2__
+      REQUIRE(bitset_simd::xor_count_avx2(lhs.data(), rhs.data(), count) == expected);
+#endif
+      REQUIRE(bitset_simd::xor_count(lhs.data(), rhs.data(), count) == expected);
+    }
+  }
+}
@@ -0,0 +1,74 @@
+#include "bitset-sliced-index.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+template <typename Predicate>
+bitset select(const std::vector<uint64_t>& values, Predicate predicate) {
+  bitset result(values.size(), false);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    result[i] = predicate(values[i]);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("bit-sliced index") {
+  std::mt19937_64 gen(3);
+  std::size_t size = GENERATE(0, 1, 63, 64, 1000);
+  uint64_t max_value = GENERATE(0, 1, 1000, uint64_t(-1));
+  CAPTURE(size, max_value);
+
+  std::uniform_int_distribution<uint64_t> dist(0, max_value);
+  std::vector<uint64_t> values(size);
+  for (uint64_t& value : values) {
+    value = dist(gen);
+  }
+  bit_sliced_index index(values);
+
+  REQUIRE(index.size() == size);
+  for (std::size_t i = 0; i < size; ++i) {
+    REQUIRE(index.value(i) == values[i]);
+  }
+
+  std::vector<uint64_t> constants = {0, 1, 2, 500, max_value / 2, max_value, uint64_t(-1)};
+  if (size > 0) {
+    constants.push_back(values[size / 2]);
+  }
+  for (uint64_t c : constants) {
+    CAPTURE(c);
+    CHECK(index.equal(c) == select(values, [c](uint64_t x) { return x == c; }));
+    CHECK(index.not_equal(c) == select(values, [c](uint64_t x) { return x != c; }));
+    CHECK(index.less(c) == select(values, [c](uint64_t x) { return x < c; }));
+    CHECK(index.less_equal(c) == select(values, [c](uint64_t x) { return x <= c; }));
+    CHECK(index.greater(c) == select(values, [c](uint64_t x) { return x > c; }));
+    CHECK(index.greater_equal(c) == select(values, [c](uint64_t x) { return x >= c; }));
+    for (uint64_t d : constants) {
+      CHECK(index.between(c, d) == select(values, [c, d](uint64_t x) { return c <= x && x < d; }));
+    }
+  }
+
+  bitset filter = select(values, [](uint64_t x) { return x % 3 == 0; });
+  uint64_t expected_sum = 0;
+  uint64_t expected_filtered_sum = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    expected_sum += values[i];
+    expected_filtered_sum += filter[i] ? values[i] : 0;
+  }
+  CHECK(index.sum() == expected_sum);
+  CHECK(index.sum(filter) == expected_filtered_sum);
+}
+
+TEST_CASE("and_count") {
+  bitset bs_1("1101101110110111011010000111101");
+  bitset bs_2("0111011011101101110111011101110");
+  std::size_t offset = GENERATE(0, 1, 7);
+  CAPTURE(offset);
+  CHECK(and_count(bs_1.subview(offset), bs_2.subview(offset)) == (bs_1.subview(offset) & bs_2.subview(offset)).count());
+}
@@ -0,0 +1,53 @@
+#include "bitset-sorted.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST_CASE("bitset and sorted id list") {
+  std::mt19937 gen(5);
+  std::size_t size = GENERATE(1, 64, 100'000);
+  double density = GENERATE(0.0001, 0.01, 0.5);
+  std::size_t offset = GENERATE(0, 3);
+  CAPTURE(size, density, offset);
+
+  bitset storage(size + offset, false);
+  bitset::view bits = storage.subview(offset);
+  std::bernoulli_distribution bit_dist(0.4);
+  std::bernoulli_distribution id_dist(density);
+  std::vector<uint32_t> ids;
+  for (uint32_t i = 0; i < size; ++i) {
+    bits[i] = bit_dist(gen);
+    if (id_dist(gen) || i + 1 == size) {
+      ids.push_back(i);
+    }
+  }
+  std::vector<uint64_t> wide_ids(ids.begin(), ids.end());
+
+  std::vector<uint32_t> expected_intersection;
+  std::vector<uint32_t> expected_difference;
+  for (uint32_t id : ids) {
+    (bits[id] ? expected_intersection : expected_difference).push_back(id);
+  }
+
+  bitset::const_view const_bits = bits;
+  CHECK(bitset_sorted::intersect(const_bits, ids) == expected_intersection);
+  CHECK(bitset_sorted::difference(ids, const_bits) == expected_difference);
+  CHECK(bitset_sorted::intersect_count(const_bits, ids) == expected_intersection.size());
+
+  std::vector<uint64_t> wide_intersection = bitset_sorted::intersect(const_bits, wide_ids);
+  CHECK(std::vector<uint32_t>(wide_intersection.begin(), wide_intersection.end()) == expected_intersection);
+  CHECK(bitset_sorted::difference(wide_ids, const_bits).size() == expected_difference.size());
+  CHECK(bitset_sorted::intersect_count(const_bits, wide_ids) == expected_intersection.size());
+}
+
+TEST_CASE("bitset and empty id list") {
+  bitset bs(100, true);
+  CHECK(bitset_sorted::intersect(bs, std::span<const uint32_t>()).empty());
+  CHECK(bitset_sorted::difference(std::span<const uint64_t>(), bs).empty());
+  CHECK(bitset_sorted::intersect_count(bs, std::span<const uint32_t>()) == 0);
+}
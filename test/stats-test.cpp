@@ -0,0 +1,45 @@
+#include "bitset-stats.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using bitset_stats::op_kind;
+
+TEST_CASE("statistics snapshot") {
+  bitset_stats::reset();
+
+  bitset bs_1(200, true);
+  bitset bs_2(200, false);
+  bs_1 &= bs_2;
+  bs_1.subview(3) |= bs_2.subview(3);
+  bs_2.flip();
+  std::size_t ones = bs_2.count();
+  bool equal = (bs_1 == bs_2);
+
+  bitset_stats::snapshot stats = bitset_stats::take_snapshot();
+
+  CHECK(ones == 200);
+  CHECK_FALSE(equal);
+  if constexpr (bitset_stats::enabled) {
+    CHECK(stats.allocations == 2);
+    CHECK(stats.allocated_bytes == 2 * 4 * sizeof(bitset::word_type));
+
+    CHECK(stats[op_kind::binary].calls == 2);
+    CHECK(stats[op_kind::binary].aligned_calls == 1);
+    CHECK(stats[op_kind::binary].unaligned_calls == 1);
+    CHECK(stats[op_kind::binary].bytes == 2 * 4 * sizeof(bitset::word_type));
+    CHECK(stats[op_kind::binary].bytes_histogram[6] == 2);
+
+    CHECK(stats[op_kind::unary].calls == 1);
+    CHECK(stats[op_kind::scan].calls == 1);
+    CHECK(stats[op_kind::compare].calls == 1);
+    CHECK(stats[op_kind::indices].calls == 0);
+
+    bitset_stats::reset();
+    CHECK(bitset_stats::take_snapshot().allocations == 0);
+  } else {
+    CHECK(stats.allocations == 0);
+    CHECK(stats[op_kind::binary].calls == 0);
+    CHECK(stats[op_kind::scan].bytes == 0);
+  }
+}
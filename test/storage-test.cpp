@@ -0,0 +1,43 @@
+#include "bitset-storage.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstdint>
+
+TEST_CASE("storage alignment") {
+  bool prefault = GENERATE(false, true);
+  CAPTURE(prefault);
+  bitset_storage::set_prefault(prefault);
+
+  std::size_t threshold_words = bitset_storage::HUGE_PAGE_THRESHOLD / sizeof(bitset::word_type);
+  std::size_t words = GENERATE_COPY(1, 3, 1000, threshold_words - 1, threshold_words, threshold_words + 5);
+  CAPTURE(words);
+
+  bitset::word_type* data = bitset_storage::allocate(words);
+  REQUIRE(data != nullptr);
+  CHECK(reinterpret_cast<std::uintptr_t>(data) % bitset_storage::ALIGNMENT == 0);
+  if (bitset_storage::mapped(words)) {
+    CHECK(reinterpret_cast<std::uintptr_t>(data) % bitset_storage::HUGE_PAGE_SIZE == 0);
+  }
+  for (std::size_t i = 0; i < words; ++i) {
+    data[i] = i;
+  }
+  CHECK(data[words - 1] == words - 1);
+  bitset_storage::deallocate(data, words);
+
+  bitset_storage::set_prefault(false);
+}
+
+TEST_CASE("large bitset") {
+  std::size_t size = bitset_storage::HUGE_PAGE_THRESHOLD * 8 + 3;
+  bitset bs(size, false);
+  bs[size - 1] = true;
+  bs.subview(100, 1000).set();
+
+  bitset copy = bs;
+  CHECK(copy.count() == 1001);
+  CHECK(copy[size - 1]);
+  CHECK(copy == bs);
+}
@@ -0,0 +1,62 @@
+#include "bitset-streaming.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <string>
+
+TEST_CASE("out-of-place operations with streaming stores") {
+  auto policy = GENERATE(
+      bitset_streaming::policy::automatic,
+      bitset_streaming::policy::always,
+      bitset_streaming::policy::never
+  );
+  bitset_streaming::set_policy(policy);
+
+  SECTION("small") {
+    std::size_t offset = GENERATE(0, 3);
+    CAPTURE(offset);
+
+    const bitset bs_1("01101100101100110101110101100101101100011101011001010110110101011101010110001011011110100");
+    const bitset bs_2("10110101011011010001101011001010110111001010010111001011001010101010110110011101001100010");
+    bitset::const_view lhs = bs_1.subview(offset);
+    bitset::const_view rhs = bs_2.subview(offset);
+
+    bitset expected_and(lhs);
+    expected_and &= rhs;
+    bitset expected_or(lhs);
+    expected_or |= rhs;
+    bitset expected_xor(lhs);
+    expected_xor ^= rhs;
+    bitset expected_not(lhs);
+    expected_not.flip();
+
+    CHECK((lhs & rhs) == expected_and);
+    CHECK((lhs | rhs) == expected_or);
+    CHECK((lhs ^ rhs) == expected_xor);
+    CHECK(~lhs == expected_not);
+    CHECK((~lhs).count() == lhs.size() - lhs.count());
+
+    bitset copy = bs_1;
+    CHECK(copy == bs_1);
+  }
+
+  SECTION("larger than cache budget") {
+    bitset_streaming::set_cache_budget(1024);
+    std::size_t size = 100'000 + 13;
+    bitset bs_1(size, false);
+    bitset bs_2(size, true);
+    bs_1.subview(0, size / 2).set();
+    bs_2.subview(size / 3).reset();
+
+    CHECK((bs_1 & bs_2).count() == size / 3);
+    CHECK((bs_1 | bs_2).count() == size / 2);
+    CHECK((~bs_1).count() == size - size / 2);
+    CHECK(bitset(bs_2) == bs_2);
+    bitset_streaming::set_cache_budget(bitset_streaming::DEFAULT_CACHE_BUDGET);
+  }
+
+  bitset_streaming::set_policy(bitset_streaming::policy::automatic);
+}
@@ -7,6 +7,15 @@ std::vector<bool> string_to_bools(std::string_view str) {
   return {view.begin(), view.end()};
 }
 
+bitset random_bitset(std::size_t size, std::mt19937& gen) {
+  bitset result(size, false);
+  std::bernoulli_distribution dist(0.5);
+  for (std::size_t i = 0; i < size; ++i) {
+    result[i] = dist(gen);
+  }
+  return result;
+}
+
 bitset_equals_string::bitset_equals_string(std::string_view expected)
     : _expected(expected) {}
 
@@ -4,10 +4,15 @@
 
 #include <catch2/matchers/catch_matchers.hpp>
 
+#include <cstddef>
+#include <random>
 #include <vector>
 
 std::vector<bool> string_to_bools(std::string_view str);
 
+// Bitset of `size` independent fair random bits.
+bitset random_bitset(std::size_t size, std::mt19937& gen);
+
 struct bitset_equals_string : Catch::Matchers::MatcherBase<bitset> {
   explicit bitset_equals_string(std::string_view expected);
 